@@ -14,13 +14,98 @@ struct cdeque_node_t {
 
 
 
+// node pool, page sized slabs cut into cells of node + item, free cells linked through their first word
+// slab
+// +------+--------+--------+-----+
+// | next | cell 0 | cell 1 | ... |
+// +------+--------+--------+-----+
+#define CDEQUE_POOL_SLAB   4096
+#define CDEQUE_POOL_HEAD   16
+
+struct cdeque_pool_t {
+    void*                       slabs;
+    void*                       cells;
+    uint64_t                    cellsize;
+    uint8_t                     enabled;
+};
+
+typedef struct cdeque_pool_t  cdeque_pool;
+
+/*   pool_alloc: take a free cell, carve a new slab when none is left
+ *   pool: pool pointer
+ *   size: cell bytes, kept until the pool is released
+ *   return:  return cell pointer, NULL if out of memory
+ */
+static void*       cdeque_pool_alloc(cdeque_pool *pool, uint64_t size) {
+	uint64_t slabsize, count;
+	void *slab = NULL, *cell = NULL;
+	if (pool->cells == NULL) {
+		if (pool->slabs == NULL)
+			pool->cellsize = (size + 15) & ~((uint64_t) 15);
+		slabsize = CDEQUE_POOL_HEAD + pool->cellsize;
+		if (slabsize < CDEQUE_POOL_SLAB)
+			slabsize = CDEQUE_POOL_SLAB;
+		slab = malloc(slabsize);
+		if (slab == NULL)
+			return NULL;
+		*(void**) slab = pool->slabs;
+		pool->slabs = slab;
+		// link from the back, cells are handed out in address order
+		for (count = (slabsize - CDEQUE_POOL_HEAD) / pool->cellsize; count > 0; --count) {
+			cell = (uint8_t*) slab + CDEQUE_POOL_HEAD + (count - 1) * pool->cellsize;
+			*(void**) cell = pool->cells;
+			pool->cells = cell;
+		}
+	}
+	cell = pool->cells;
+	pool->cells = *(void**) cell;
+	return cell;
+}
+
+/*   pool_free: give a cell back to the pool
+ *   pool: pool pointer
+ *   cell: cell pointer
+ */
+static void        cdeque_pool_free(cdeque_pool *pool, void* cell) {
+	*(void**) cell = pool->cells;
+	pool->cells = cell;
+}
+
+/*   pool_release: free every slab, cells in use too
+ *   pool: pool pointer
+ */
+static void        cdeque_pool_release(cdeque_pool *pool) {
+	void *slab = pool->slabs, *next = NULL;
+	while (slab != NULL) {
+		next = *(void**) slab;
+		free(slab);
+		slab = next;
+	}
+	pool->slabs = NULL;
+	pool->cells = NULL;
+}
+
+// item offset from a pool node, 16 byte aligned as malloc
+#define CDEQUE_NODE_OFFSET   ((sizeof(cdeque_node) + 15) & ~((uint64_t) 15))
+
 /*   alloc: alloc new node
+ *   pool: pool pointer, node and item share one cell when enabled
  *   data: item data pointer
  *   return:  return node pointer
  */
-static cdeque_node* cdeque_node_alloc(uint64_t typesize, const void *data) {
-	cdeque_node* node = malloc(sizeof(cdeque_node));
-    node->data = malloc(typesize);
+static cdeque_node* cdeque_node_alloc(cdeque_pool *pool, uint64_t typesize, const void *data) {
+	cdeque_node* node = NULL;
+	if (pool->enabled) {
+		node = cdeque_pool_alloc(pool, CDEQUE_NODE_OFFSET + typesize);
+		if (node == NULL)
+			return NULL;
+		node->data = (uint8_t*) node + CDEQUE_NODE_OFFSET;
+	} else {
+		node = malloc(sizeof(cdeque_node));
+		if (node == NULL)
+			return NULL;
+		node->data = malloc(typesize);
+	}
     if (data != NULL) {
     	memcpy(node->data, data, typesize);
     }
@@ -54,12 +139,17 @@ static cdeque_node* cdeque_node_erase(cdeque_node* node) {
 }
 
 /*   free: free node
+ *   pool: pool pointer, the cell goes back to it when enabled
  *   node: node pointer
  */
-static void        cdeque_node_free(cdeque_node *node) {
+static void        cdeque_node_free(cdeque_pool *pool, cdeque_node *node) {
 	cdeque_node *prev = node->prev, *next = node->next;
 	prev->next = next;
 	next->prev = prev;
+	if (pool->enabled) {
+		cdeque_pool_free(pool, node);
+		return;
+	}
 	if (node->data)
 		free(node->data);
 	free(node);
@@ -96,6 +186,7 @@ struct cdeque_data_t {
     cdeque_node                 head;
     uint64_t                    count;
     uint64_t                    typesize;
+    cdeque_pool                 pool;
 };
 
 typedef struct cdeque_data_t  cdeque_data;
@@ -109,12 +200,19 @@ static    void    cdeque_static_clear(cdeque *thiz) {
 	if (thiz == NULL) 
 		return;
 	thiz_data = (cdeque_data *) thiz;
+	if (thiz_data->pool.enabled) {
+		// nodes live in the slabs, give them back in bulk
+		thiz_data->head.next = thiz_data->head.prev = &(thiz_data->head);
+		thiz_data->count = 0;
+		cdeque_pool_release(&(thiz_data->pool));
+		return;
+	}
 	if (thiz_data->count <= 0)
 		return;
 	node = thiz_data->head.next;
 	while(node != &(thiz_data->head)) {
 		next = node->next;
-        cdeque_node_free(node);
+        cdeque_node_free(&(thiz_data->pool), node);
         node = next;
 	}
 	thiz_data->head.next = thiz_data->head.prev = &(thiz_data->head);
@@ -130,14 +228,15 @@ static    void    cdeque_static_free(cdeque *thiz) {
 	if (thiz == NULL) 
 		return;
 	thiz_data = (cdeque_data *) thiz;
-	if (thiz_data->count <= 0) {
+	if ((thiz_data->count <= 0) || thiz_data->pool.enabled) {
+		cdeque_pool_release(&(thiz_data->pool));
 		free(thiz_data);
 		return;
 	}
 	node = thiz_data->head.next;
 	while(node != &(thiz_data->head)) {
 		next = node->next;
-        cdeque_node_free(node);
+        cdeque_node_free(&(thiz_data->pool), node);
         node = next;
 	}
 	thiz_data->head.next = thiz_data->head.prev = &(thiz_data->head);
@@ -221,7 +320,9 @@ static    void    cdeque_static_push_front(cdeque *thiz, const void* val) {
 	if (thiz == NULL) 
 		return;
 	thiz_data = (cdeque_data *) thiz;
-	node = cdeque_node_alloc(thiz_data->typesize, val);
+	node = cdeque_node_alloc(&(thiz_data->pool), thiz_data->typesize, val);
+	if (node == NULL)
+		return;
 	cdeque_node_insert(&(thiz_data->head), node);
 	++thiz_data->count;
 }
@@ -236,7 +337,9 @@ static    void    cdeque_static_push_back(cdeque *thiz, const void* val) {
 	if (thiz == NULL) 
 		return;
 	thiz_data = (cdeque_data *) thiz;
-	node = cdeque_node_alloc(thiz_data->typesize, val);
+	node = cdeque_node_alloc(&(thiz_data->pool), thiz_data->typesize, val);
+	if (node == NULL)
+		return;
 	cdeque_node_insert(thiz_data->head.prev, node);
 	++thiz_data->count;
 }
@@ -251,7 +354,7 @@ static    void    cdeque_static_pop_front(cdeque *thiz) {
 	thiz_data = (cdeque_data *) thiz;
 	if (thiz_data->count <= 0)
 		return;
-	cdeque_node_free(thiz_data->head.next);
+	cdeque_node_free(&(thiz_data->pool), thiz_data->head.next);
     --thiz_data->count;
 }
 
@@ -265,7 +368,7 @@ static    void    cdeque_static_pop_back(cdeque *thiz) {
 	thiz_data = (cdeque_data *) thiz;
 	if (thiz_data->count <= 0)
 		return;
-	cdeque_node_free(thiz_data->head.prev);
+	cdeque_node_free(&(thiz_data->pool), thiz_data->head.prev);
     --thiz_data->count;
 }
 
@@ -287,11 +390,13 @@ static    void    cdeque_static_copy(cdeque *thiz, cdeque *that) {
     that_data->typesize = thiz_data->typesize;
     while (node != &(thiz_data->head)) {
         prev = that_data->head.prev;
-        next = cdeque_node_alloc(thiz_data->typesize, node->data);
+        next = cdeque_node_alloc(&(that_data->pool), thiz_data->typesize, node->data);
+        if (next == NULL)
+        	break;
     	cdeque_node_insert(prev, next);
     	node = node->next;
+    	++that_data->count;
     }
-    that_data->count = thiz_data->count;
 }
 
 /*   equal: compare thiz with that
@@ -322,6 +427,72 @@ static    uint8_t    cdeque_static_equal(cdeque *thiz, cdeque *that) {
     return 1;	
 }
 
+/*   take: link the nodes of from behind head, from becomes empty
+ *   head: empty head node
+ *   from: head node
+ */
+static void        cdeque_head_take(cdeque_node *head, cdeque_node *from) {
+	if (from->next == from) {
+		head->next = head->prev = head;
+		return;
+	}
+	head->next       = from->next;
+	head->prev       = from->prev;
+	head->next->prev = head;
+	head->prev->next = head;
+	from->next = from->prev = from;
+}
+
+/*   swap: exchange the items of thiz and that, no node is copied, the pools go with the nodes
+ *   thiz: cdeque pointer
+ *   that: cdeque pointer
+ */
+static    void    cdeque_static_swap(cdeque *thiz, cdeque *that) {
+	cdeque_node head;
+	cdeque_pool pool;
+	uint64_t count, typesize;
+	cdeque_data *thiz_data = NULL, *that_data = NULL;
+	if ((thiz == NULL) || (that == NULL) || (thiz == that)) {
+		return;
+	}
+	thiz_data = (cdeque_data *) thiz;
+	that_data = (cdeque_data *) that;
+	cdeque_head_take(&head, &(thiz_data->head));
+	cdeque_head_take(&(thiz_data->head), &(that_data->head));
+	cdeque_head_take(&(that_data->head), &head);
+	count    = thiz_data->count;
+	typesize = thiz_data->typesize;
+	thiz_data->count    = that_data->count;
+	thiz_data->typesize = that_data->typesize;
+	that_data->count    = count;
+	that_data->typesize = typesize;
+	pool            = thiz_data->pool;
+	thiz_data->pool = that_data->pool;
+	that_data->pool = pool;
+}
+
+/*   move_into: free the items of thiz and take the nodes of that, that becomes empty
+ *   thiz: cdeque pointer
+ *   that: cdeque pointer, its pool goes with the nodes, it gets the empty pool of thiz
+ */
+static    void    cdeque_static_move_into(cdeque *thiz, cdeque *that) {
+	cdeque_pool pool;
+	cdeque_data *thiz_data = NULL, *that_data = NULL;
+	if ((thiz == NULL) || (that == NULL) || (thiz == that)) {
+		return;
+	}
+	thiz_data = (cdeque_data *) thiz;
+	that_data = (cdeque_data *) that;
+	thiz->clear(thiz);
+	cdeque_head_take(&(thiz_data->head), &(that_data->head));
+	thiz_data->count    = that_data->count;
+	thiz_data->typesize = that_data->typesize;
+	that_data->count    = 0;
+	pool            = thiz_data->pool;
+	thiz_data->pool = that_data->pool;
+	that_data->pool = pool;
+}
+
 /*   cdeque_alloc: malloc cdeque pointer
  *   typesize: cdeque item size
  *   return: cdeque pointer
@@ -342,6 +513,10 @@ cdeque* cdeque_alloc(uint64_t typesize) {
     thiz_data->count    = 0;
     thiz_data->head.prev = thiz_data->head.next = &(thiz_data->head);
     thiz_data->head.data = NULL;
+    thiz_data->pool.slabs    = NULL;
+    thiz_data->pool.cells    = NULL;
+    thiz_data->pool.cellsize = 0;
+    thiz_data->pool.enabled  = 0;
 
     thiz = (cdeque *) &(thiz_data->deque);
 
@@ -359,6 +534,21 @@ cdeque* cdeque_alloc(uint64_t typesize) {
 	thiz->pop_back     = cdeque_static_pop_back;
 	thiz->copy   = cdeque_static_copy;
 	thiz->equal  = cdeque_static_equal;
+	thiz->swap   = cdeque_static_swap;
+	thiz->move_into  = cdeque_static_move_into;
 
     return thiz;
 }
+
+/*   cdeque_alloc_pool: malloc cdeque pointer, nodes come from page sized slabs
+ *   typesize: cdeque item size
+ *   return: cdeque pointer
+ */
+cdeque* cdeque_alloc_pool(uint64_t typesize) {
+	cdeque *thiz = cdeque_alloc(typesize);
+	if (thiz == NULL) {
+		return NULL;
+	}
+	((cdeque_data *) thiz)->pool.enabled = 1;
+	return thiz;
+}
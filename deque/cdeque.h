@@ -91,6 +91,18 @@ struct cdeque_t {
  *   return: thiz == that
  */
     uint8_t   (*equal)(cdeque *thiz, cdeque *that);
+
+/*   swap: exchange the items of thiz and that, no node is copied
+ *   thiz: cdeque pointer
+ *   that: cdeque pointer
+ */
+    void      (*swap)(cdeque *thiz, cdeque *that);
+
+/*   move_into: free the items of thiz and take the nodes of that, that becomes empty
+ *   thiz: cdeque pointer
+ *   that: cdeque pointer
+ */
+    void      (*move_into)(cdeque *thiz, cdeque *that);
 };
 
 /*   cdeque_alloc: malloc cdeque pointer
@@ -99,6 +111,13 @@ struct cdeque_t {
  */
 cdeque* cdeque_alloc(uint64_t typesize);
 
+/*   cdeque_alloc_pool: malloc cdeque pointer, node and item share one cell of a page sized slab
+ *   push and pop reuse free cells, clear and free give the slabs back at once
+ *   typesize: cdeque item size
+ *   return: cdeque pointer
+ */
+cdeque* cdeque_alloc_pool(uint64_t typesize);
+
 
 #ifdef __cplusplus
 }
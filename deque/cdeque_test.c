@@ -34,9 +34,15 @@ static void test_deque1();
 
 static void test_deque2();
 
+static void test_deque3();
+
+static void test_deque4();
+
 int main(int argc, const char *argv[]) {
 	test_deque1();
 	test_deque2();
+	test_deque3();
+	test_deque4();
 	return 0;
 }
 
@@ -66,4 +72,56 @@ void test_deque1() {
 
 void test_deque2() {
 
+}
+
+void test_deque3() {
+    printf("test swap, move_into\n");
+    int buf[] = {0x01, 0x12, 0x23, 0x34, 0x45};
+    cdeque *queue  = cdeque_alloc(sizeof(int));
+    cdeque *queue1 = cdeque_alloc(sizeof(int));
+    for (int i = 0 ; i < 5; ++i) {
+        queue->push_back(queue, &buf[i]);
+    }
+    queue1->push_front(queue1, &buf[0]);
+    queue->swap(queue, queue1);
+    printf("%lld %lld\n", queue->size(queue), queue1->size(queue1));
+    queue1->push_front(queue1, &buf[1]);
+    queue->move_into(queue, queue1);
+    printf("%d\n", queue1->empty(queue1));
+    queue1->push_back(queue1, &buf[2]);
+    test_print_back(queue);
+    test_print_front(queue1);
+    queue->free(queue);
+    queue1->free(queue1);
+}
+
+void test_deque4() {
+    printf("test alloc_pool\n");
+    int i, sum = 0;
+    cdeque *queue  = cdeque_alloc_pool(sizeof(int));
+    cdeque *queue1 = cdeque_alloc(sizeof(int));
+    for (i = 0 ; i < 1000; ++i) {
+        if (i % 2)
+            queue->push_back(queue, &i);
+        else
+            queue->push_front(queue, &i);
+    }
+    for (i = 0 ; i < 990; ++i) {
+        sum += *((int*)queue->back(queue));
+        queue->pop_back(queue);
+    }
+    printf("%d %lld\n", sum, queue->size(queue));
+    queue->clear(queue);
+    for (i = 0 ; i < 5; ++i) {
+        queue->push_back(queue, &i);
+    }
+    queue->copy(queue, queue1);
+    queue1->pop_front(queue1);
+    queue->swap(queue, queue1);
+    queue->push_back(queue, &i);
+    queue1->push_front(queue1, &i);
+    test_print_front(queue);
+    test_print_back(queue1);
+    queue->free(queue);
+    queue1->free(queue1);
 }
\ No newline at end of file
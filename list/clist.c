@@ -3,21 +3,31 @@
 #include "clist.h"
 
 
+// node links, the item follows in the same allocation
+// +------+------+-----------------+
+// | next | prev | item (typesize) |
+// +------+------+-----------------+
 struct clist_node_t {
     clist_node   *next;
     clist_node   *prev;
-    void         *data;
 };
 
-/*   alloc: alloc new node
+// item offset from the node, 16 byte aligned as malloc
+#define CLIST_NODE_OFFSET   ((sizeof(clist_node) + 15) & ~((uint64_t) 15))
+
+// steps between two indexes
+#define CLIST_DISTANCE(a, b)   (((a) > (b)) ? ((a) - (b)) : ((b) - (a)))
+
+/*   alloc: alloc new node, links and item in one allocation
  *   data: item data pointer
  *   return:  return node pointer
  */
 clist_node* clist_node_alloc(uint64_t typesize, const void *data) {
-	clist_node* node = malloc(sizeof(clist_node));
-    node->data = malloc(typesize);
+	clist_node* node = malloc(CLIST_NODE_OFFSET + typesize);
+	if (node == NULL)
+		return NULL;
     if (data != NULL) {
-    	memcpy(node->data, data, typesize);
+    	memcpy((uint8_t*) node + CLIST_NODE_OFFSET, data, typesize);
     }
 	node->next = node->prev = node;
 	return node;
@@ -55,8 +65,6 @@ void        clist_node_free(clist_node *node) {
 	clist_node *prev = node->prev, *next = node->next;
 	prev->next = next;
 	next->prev = prev;
-	if (node->data)
-		free(node->data);
 	free(node);
 }
 
@@ -65,7 +73,7 @@ void        clist_node_free(clist_node *node) {
  *   return: return data pointer
  */
 void*       clist_node_data(clist_node* node) {
-	return node->data;
+	return (uint8_t*) node + CLIST_NODE_OFFSET;
 }
 
 /*   next: get next node pointer
@@ -85,15 +93,314 @@ clist_node* clist_node_prev(clist_node* node) {
 }
 
 
+// node pool, page sized slabs cut into cells of node + item, free cells linked through their first word
+// slab
+// +------+--------+--------+-----+
+// | next | cell 0 | cell 1 | ... |
+// +------+--------+--------+-----+
+#define CLIST_POOL_SLAB   4096
+#define CLIST_POOL_HEAD   16
+
+struct clist_pool_t {
+    void*                       slabs;
+    void*                       cells;
+    uint64_t                    cellsize;
+    uint8_t                     enabled;
+};
+
+typedef struct clist_pool_t  clist_pool;
+
+/*   pool_alloc: take a free cell, carve a new slab when none is left
+ *   pool: pool pointer
+ *   size: cell bytes, kept until the pool is released
+ *   return:  return cell pointer, NULL if out of memory
+ */
+static void*       clist_pool_alloc(clist_pool *pool, uint64_t size) {
+	uint64_t slabsize, count;
+	void *slab = NULL, *cell = NULL;
+	if (pool->cells == NULL) {
+		if (pool->slabs == NULL)
+			pool->cellsize = (size + 15) & ~((uint64_t) 15);
+		slabsize = CLIST_POOL_HEAD + pool->cellsize;
+		if (slabsize < CLIST_POOL_SLAB)
+			slabsize = CLIST_POOL_SLAB;
+		slab = malloc(slabsize);
+		if (slab == NULL)
+			return NULL;
+		*(void**) slab = pool->slabs;
+		pool->slabs = slab;
+		// link from the back, cells are handed out in address order
+		for (count = (slabsize - CLIST_POOL_HEAD) / pool->cellsize; count > 0; --count) {
+			cell = (uint8_t*) slab + CLIST_POOL_HEAD + (count - 1) * pool->cellsize;
+			*(void**) cell = pool->cells;
+			pool->cells = cell;
+		}
+	}
+	cell = pool->cells;
+	pool->cells = *(void**) cell;
+	return cell;
+}
+
+/*   pool_free: give a cell back to the pool
+ *   pool: pool pointer
+ *   cell: cell pointer
+ */
+static void        clist_pool_free(clist_pool *pool, void* cell) {
+	*(void**) cell = pool->cells;
+	pool->cells = cell;
+}
+
+/*   pool_release: free every slab, cells in use too
+ *   pool: pool pointer
+ */
+static void        clist_pool_release(clist_pool *pool) {
+	void *slab = pool->slabs, *next = NULL;
+	while (slab != NULL) {
+		next = *(void**) slab;
+		free(slab);
+		slab = next;
+	}
+	pool->slabs = NULL;
+	pool->cells = NULL;
+}
+
+
+// hash index, chained buckets of nodes, the chain link follows the item in the node
+// +------+------+-----------------+------+-------------+-------------+------+
+// | next | prev | item (typesize) | next | equal_next  | equal_prev  | hash |
+// +------+------+-----------------+------+-------------+-------------+------+
+// a bucket chains the first item of each key, equal items hang off it in a ring in list order,
+// so find returns the first one and push, pop of equal items do not walk the ring
+#define CLIST_INDEX_BUCKETS   16
+
+struct clist_link_t {
+    clist_node                 *next;
+    clist_node                 *equal_next;
+    clist_node                 *equal_prev;
+    uint64_t                    hash;
+};
+
+typedef struct clist_link_t  clist_link;
+
+struct clist_index_t {
+    clist_node                **buckets;
+    uint64_t                    mask;
+    uint64_t                  (*hash)(const void* val);
+    int                       (*cmp)(const void* a, const void* b);
+    uint8_t                     enabled;
+};
+
+typedef struct clist_index_t  clist_index;
+
+// link offset from the node, 8 byte aligned behind the item
+#define CLIST_LINK_OFFSET(typesize)   (CLIST_NODE_OFFSET + (((typesize) + 7) & ~((uint64_t) 7)))
+
 struct clist_data_t {
 	clist                      list;
 	clist_node                 head;
     uint64_t                   count;
     uint64_t                   typesize;
+    clist_pool                 pool;
+    clist_node                *cursor;
+    uint64_t                   cursor_index;
+    clist_index                index;
 };
 
 typedef struct clist_data_t  clist_data;
 
+/*   hash_mix: fold an 8 byte word into h
+ */
+static inline uint64_t    clist_hash_mix(uint64_t h, uint64_t word) {
+	h ^= word * 0x9e3779b97f4a7c15ULL;
+	h  = (h << 31) | (h >> 33);
+	return h * 0xbf58476d1ce4e5b9ULL;
+}
+
+/*   hash: index hash of an item, the user hash or a hash of the item bytes
+ *   thiz: clist pointer
+ *   val:  item pointer
+ *   return: hash
+ */
+static    uint64_t    clist_static_hash(clist_data *thiz, const void* val) {
+	const uint8_t *ptr = val;
+	uint64_t n, word, h = 0;
+	if (thiz->index.hash != NULL)
+		return thiz->index.hash(val);
+	h = clist_hash_mix(0x84222325cbf29ce4ULL, thiz->typesize);
+	for (n = 0; n + 8 <= thiz->typesize; n += 8) {
+		memcpy(&word, ptr + n, 8);
+		h = clist_hash_mix(h, word);
+	}
+	if (n < thiz->typesize) {
+		word = 0;
+		memcpy(&word, ptr + n, thiz->typesize - n);
+		h = clist_hash_mix(h, word);
+	}
+	h ^= h >> 29;
+	h *= 0x94d049bb133111ebULL;
+	return h ^ (h >> 32);
+}
+
+/*   same: items equal, the user cmp or the item bytes
+ *   thiz: clist pointer
+ *   a:    item pointer
+ *   b:    item pointer
+ *   return: 1 if equal
+ */
+static    uint8_t    clist_static_same(clist_data *thiz, const void* a, const void* b) {
+	if (thiz->index.cmp != NULL)
+		return (thiz->index.cmp(a, b) == 0) ? 1 : 0;
+	return (memcmp(a, b, thiz->typesize) == 0) ? 1 : 0;
+}
+
+/*   link: hash index link of node
+ *   thiz: clist pointer
+ *   node: node pointer
+ *   return: link pointer
+ */
+static    clist_link*    clist_static_link(clist_data *thiz, clist_node *node) {
+	return (clist_link*) ((uint8_t*) node + CLIST_LINK_OFFSET(thiz->typesize));
+}
+
+/*   index_slot: chain slot of the first item equal to node, the walk passes one node per key
+ *   thiz: clist pointer
+ *   node: node pointer, hash set
+ *   return slot pointer, *slot is NULL if no item is equal
+ */
+static    clist_node**    clist_static_index_slot(clist_data *thiz, clist_node *node) {
+	clist_link *link = clist_static_link(thiz, node), *entry = NULL;
+	clist_node **slot = &(thiz->index.buckets[link->hash & thiz->index.mask]);
+	for (; *slot != NULL; slot = &(entry->next)) {
+		entry = clist_static_link(thiz, *slot);
+		if ((*slot == node) || ((entry->hash == link->hash) &&
+		                        clist_static_same(thiz, clist_node_data(*slot), clist_node_data(node))))
+			break;
+	}
+	return slot;
+}
+
+/*   index_insert: add node to the ring of its key, behind the equal items or before them
+ *   thiz: clist pointer
+ *   node: node pointer, hash set
+ *   back: 1 if node is behind the equal items in the list
+ */
+static    void    clist_static_index_insert(clist_data *thiz, clist_node *node, uint8_t back) {
+	clist_link *link = clist_static_link(thiz, node), *first = NULL;
+	clist_node **slot = clist_static_index_slot(thiz, node);
+	if (*slot == NULL) {
+		link->next       = NULL;
+		link->equal_next = node;
+		link->equal_prev = node;
+		*slot = node;
+		return;
+	}
+	// behind the last equal item is before the first one in the ring
+	first = clist_static_link(thiz, *slot);
+	link->equal_next = *slot;
+	link->equal_prev = first->equal_prev;
+	clist_static_link(thiz, first->equal_prev)->equal_next = node;
+	first->equal_prev = node;
+	if (!back) {
+		link->next = first->next;
+		*slot = node;
+	}
+}
+
+/*   index_erase: take node out of the ring of its key, the next equal item takes its chain slot
+ *   thiz: clist pointer
+ *   node: node pointer
+ */
+static    void    clist_static_index_erase(clist_data *thiz, clist_node *node) {
+	clist_link *link = clist_static_link(thiz, node);
+	clist_node **slot = clist_static_index_slot(thiz, node), *next = link->equal_next;
+	clist_static_link(thiz, link->equal_prev)->equal_next = next;
+	clist_static_link(thiz, next)->equal_prev = link->equal_prev;
+	if (*slot != node)
+		return;
+	if (next == node) {
+		*slot = link->next;
+		return;
+	}
+	clist_static_link(thiz, next)->next = link->next;
+	*slot = next;
+}
+
+/*   index_rebuild: relink every node into count buckets, the old buckets stay if out of memory
+ *   thiz: clist pointer
+ *   count: bucket count, power of 2
+ */
+static    void    clist_static_index_rebuild(clist_data *thiz, uint64_t count) {
+	clist_node *node = NULL, **buckets = calloc(count, sizeof(clist_node*));
+	if (buckets != NULL) {
+		free(thiz->index.buckets);
+		thiz->index.buckets = buckets;
+		thiz->index.mask    = count - 1;
+	} else {
+		memset(thiz->index.buckets, 0, (thiz->index.mask + 1) * sizeof(clist_node*));
+	}
+	// in list order, rings come out in list order
+	for (node = thiz->head.next; node != &(thiz->head); node = node->next) {
+		clist_static_index_insert(thiz, node, 1);
+	}
+}
+
+/*   node_alloc: alloc new node from the pool or with clist_node_alloc, room for the link if indexed
+ *   thiz: clist pointer
+ *   data: item data pointer
+ *   return:  return node pointer
+ */
+static    clist_node*    clist_static_node_alloc(clist_data *thiz, const void *data) {
+	clist_node *node = NULL;
+	uint64_t size = thiz->typesize;
+	if (thiz->index.enabled)
+		size = CLIST_LINK_OFFSET(thiz->typesize) - CLIST_NODE_OFFSET + sizeof(clist_link);
+	if (!thiz->pool.enabled && !thiz->index.enabled)
+		return clist_node_alloc(thiz->typesize, data);
+	if (thiz->pool.enabled)
+		node = clist_pool_alloc(&(thiz->pool), CLIST_NODE_OFFSET + size);
+	else
+		node = clist_node_alloc(size, NULL);
+	if (node == NULL)
+		return NULL;
+    if (data != NULL) {
+    	memcpy(clist_node_data(node), data, thiz->typesize);
+    }
+    if (thiz->index.enabled) {
+    	clist_static_link(thiz, node)->hash = clist_static_hash(thiz, clist_node_data(node));
+    }
+	node->next = node->prev = node;
+	return node;
+}
+
+/*   node_link: count a node just linked into the list, index it and grow the buckets
+ *   thiz: clist pointer
+ *   node: node pointer
+ *   back: 1 if node was added behind, 0 if before
+ */
+static    void    clist_static_node_link(clist_data *thiz, clist_node *node, uint8_t back) {
+	++thiz->count;
+	if (!thiz->index.enabled)
+		return;
+	clist_static_index_insert(thiz, node, back);
+	if (thiz->count > thiz->index.mask + 1)
+		clist_static_index_rebuild(thiz, (thiz->index.mask + 1) * 2);
+}
+
+/*   node_free: unlink node, give it back to the pool or free it with clist_node_free
+ *   thiz: clist pointer
+ *   node: node pointer
+ */
+static    void    clist_static_node_free(clist_data *thiz, clist_node *node) {
+	if (thiz->index.enabled)
+		clist_static_index_erase(thiz, node);
+	if (!thiz->pool.enabled) {
+		clist_node_free(node);
+		return;
+	}
+	clist_node_erase(node);
+	clist_pool_free(&(thiz->pool), node);
+}
+
 /*   clear: clear data, but not free
  *   thiz: clist pointer
  */
@@ -103,8 +410,19 @@ static    void    clist_static_clear(clist *_thiz) {
 	if (_thiz == NULL) 
 		return;
 	thiz = (clist_data*) _thiz;
+	if (thiz->index.enabled && (thiz->count > 0))
+		memset(thiz->index.buckets, 0, (thiz->index.mask + 1) * sizeof(clist_node*));
+	if (thiz->pool.enabled) {
+		// nodes live in the slabs, give them back in bulk
+		thiz->head.next = thiz->head.prev = &(thiz->head);
+		thiz->count  = 0;
+		thiz->cursor = NULL;
+		clist_pool_release(&(thiz->pool));
+		return;
+	}
 	if (thiz->count <= 0)
 		return;
+	thiz->cursor = NULL;
 	node = thiz->head.next;
 	while(node != &(thiz->head)) {
 		next = node->next;
@@ -124,7 +442,9 @@ static    void    clist_static_free(clist *_thiz) {
 	if (_thiz == NULL) 
 		return;
 	thiz = (clist_data*) _thiz;
-	if (thiz->count <= 0) {
+	free(thiz->index.buckets);
+	if ((thiz->count <= 0) || thiz->pool.enabled) {
+		clist_pool_release(&(thiz->pool));
 		free(thiz);
 		return;
 	}
@@ -253,7 +573,7 @@ static    clist_node*    clist_static_rend(clist *_thiz) {
     return &(thiz->head);
 }
 
-/*   at: index item pointer
+/*   at: index item pointer, walk from the nearest of head, tail and the last at node
  *   thiz: clist pointer
  *   index: item index
  *   return index item pointer
@@ -261,28 +581,59 @@ static    clist_node*    clist_static_rend(clist *_thiz) {
 static    clist_node*    clist_static_at(clist *_thiz, uint64_t index) {
 	clist_node *node = NULL;
 	clist_data *thiz = NULL;
-	uint64_t i = 0;
+	uint64_t i = 0, distance = 0;
 	if (_thiz == NULL) 
 		return NULL;
 	thiz = (clist_data*) _thiz;
     if (index >= thiz->count)
         return NULL;
-    node = thiz->head.next;
-    while (i++ < index) {
+    node     = thiz->head.next;
+    distance = index;
+    if (thiz->count - 1 - index < distance) {
+    	node     = thiz->head.prev;
+    	i        = thiz->count - 1;
+    	distance = i - index;
+    }
+    if ((thiz->cursor != NULL) && (CLIST_DISTANCE(thiz->cursor_index, index) < distance)) {
+    	node = thiz->cursor;
+    	i    = thiz->cursor_index;
+    }
+    for (; i < index; ++i) {
     	node = node->next;
     }
+    for (; i > index; --i) {
+    	node = node->prev;
+    }
+    thiz->cursor       = node;
+    thiz->cursor_index = index;
     return node;
 }
 
+/*   find: first node of an item equal to val, through the hash index if indexed
+ *   thiz: clist pointer
+ *   val:  item pointer
+ *   return node pointer, NULL if not found
+ */
 static    clist_node*    clist_static_find(clist *_thiz, const void* val) {
 	clist_node *node = NULL;
+	clist_link *link = NULL;
 	clist_data *thiz = NULL;
+	uint64_t hash = 0;
 	if (_thiz == NULL) 
 		return NULL;
 	thiz = (clist_data*) _thiz;
+	if (thiz->index.enabled) {
+		hash = clist_static_hash(thiz, val);
+		for (node = thiz->index.buckets[hash & thiz->index.mask]; node != NULL; node = link->next) {
+			link = clist_static_link(thiz, node);
+			if ((link->hash == hash) && clist_static_same(thiz, clist_node_data(node), val))
+				return node;
+		}
+		return NULL;
+	}
     node = thiz->head.next;
     while (node != &(thiz->head)) {
-    	if (memcmp(node->data, val, thiz->typesize) == 0) {
+    	if (memcmp(clist_node_data(node), val, thiz->typesize) == 0) {
     		return node;
     	}
     	node = node->next;
@@ -300,9 +651,11 @@ static    void    clist_static_push_back(clist *_thiz, const void* val) {
 	if (_thiz == NULL) 
 		return;
 	thiz = (clist_data*) _thiz;
-	node = clist_node_alloc(thiz->typesize, val);
+	node = clist_static_node_alloc(thiz, val);
+	if (node == NULL)
+		return;
 	clist_node_insert(thiz->head.prev, node);
-	++thiz->count;
+	clist_static_node_link(thiz, node, 1);
 }
 
 /*   push_front: add first item before 
@@ -315,9 +668,12 @@ static    void    clist_static_push_front(clist *_thiz, const void* val) {
 	if (_thiz == NULL) 
 		return;
 	thiz = (clist_data*) _thiz;
-	node = clist_node_alloc(thiz->typesize, val);
+	node = clist_static_node_alloc(thiz, val);
+	if (node == NULL)
+		return;
 	clist_node_insert(&(thiz->head), node);
-	++thiz->count;
+	clist_static_node_link(thiz, node, 0);
+	++thiz->cursor_index;
 }
 
 /*   pop_back: delete last item 
@@ -330,7 +686,9 @@ static    void    clist_static_pop_back(clist *_thiz) {
 	thiz = (clist_data*) _thiz;
 	if (thiz->count <= 0)
 		return;
-    clist_node_free(thiz->head.prev);
+	if (thiz->cursor == thiz->head.prev)
+		thiz->cursor = NULL;
+    clist_static_node_free(thiz, thiz->head.prev);
     --thiz->count;
 }
 
@@ -344,7 +702,10 @@ static    void    clist_static_pop_front(clist *_thiz) {
 	thiz = (clist_data*) _thiz;
 	if (thiz->count <= 0)
 		return;
-    clist_node_free(thiz->head.next);
+	if (thiz->cursor == thiz->head.next)
+		thiz->cursor = NULL;
+	--thiz->cursor_index;
+    clist_static_node_free(thiz, thiz->head.next);
     --thiz->count;	
 }
 
@@ -355,17 +716,33 @@ static    void    clist_static_pop_front(clist *_thiz) {
 static    void    clist_static_remove(clist *_thiz, void* val) {
 	clist_node *node = NULL;
 	clist_data *thiz = NULL;
+	uint64_t i = 0;
 	if (_thiz == NULL) 
 		return;
 	thiz = (clist_data*) _thiz;
+	if (thiz->index.enabled) {
+		// position unknown, the cursor goes
+		node = _thiz->find(_thiz, val);
+		if (node == NULL)
+			return;
+		thiz->cursor = NULL;
+		clist_static_node_free(thiz, node);
+		--thiz->count;
+		return;
+	}
     node = thiz->head.next;
     while (node != &(thiz->head)) {
-    	if (memcmp(node->data, val, thiz->typesize) == 0) {
-		    clist_node_free(node);
+    	if (memcmp(clist_node_data(node), val, thiz->typesize) == 0) {
+    		if (thiz->cursor == node)
+    			thiz->cursor = NULL;
+    		if (i < thiz->cursor_index)
+    			--thiz->cursor_index;
+		    clist_static_node_free(thiz, node);
 		    --thiz->count;
 		    return;
     	}
     	node = node->next;
+    	++i;
     }
 }
 
@@ -404,6 +781,9 @@ static    void    clist_static_reverse(clist *_thiz) {
         clist_node_insert(&(thiz->head), node);
         node = next;
     }
+    thiz->cursor_index = thiz->count - 1 - thiz->cursor_index;
+    if (thiz->index.enabled)
+    	clist_static_index_rebuild(thiz, thiz->index.mask + 1);
 }
 
 /*   copy: copy value from thiz to that
@@ -447,7 +827,7 @@ static    uint8_t    clist_static_equal(clist *_thiz, clist *_that) {
     node = thiz->head.next;
     next = that->head.next;
     while (node != &(thiz->head)) {
-    	if (memcmp(node->data, next->data, thiz->typesize) != 0)
+    	if (memcmp(clist_node_data(node), clist_node_data(next), thiz->typesize) != 0)
     		return 0;
     	node = node->next;
     	next = next->next;
@@ -455,6 +835,89 @@ static    uint8_t    clist_static_equal(clist *_thiz, clist *_that) {
     return 1;	
 }
 
+/*   take: link the nodes of from behind head, from becomes empty
+ *   head: empty head node
+ *   from: head node
+ */
+static    void    clist_head_take(clist_node *head, clist_node *from) {
+	if (from->next == from) {
+		head->next = head->prev = head;
+		return;
+	}
+	head->next       = from->next;
+	head->prev       = from->prev;
+	head->next->prev = head;
+	head->prev->next = head;
+	from->next = from->prev = from;
+}
+
+/*   swap: exchange the items of thiz and that, no node is copied, the pools go with the nodes
+ *   thiz: clist pointer
+ *   that: clist pointer
+ */
+static    void    clist_static_swap(clist *_thiz, clist *_that) {
+	clist_node head, *cursor;
+	clist_pool pool;
+	clist_index index;
+	uint64_t count, typesize, cursor_index;
+	clist_data *thiz = NULL, *that = NULL;
+	if ((_thiz == NULL) || (_that == NULL) || (_thiz == _that)) {
+		return;
+	}
+	thiz = (clist_data*) _thiz;
+	that = (clist_data*) _that;
+	clist_head_take(&head, &(thiz->head));
+	clist_head_take(&(thiz->head), &(that->head));
+	clist_head_take(&(that->head), &head);
+	count          = thiz->count;
+	typesize       = thiz->typesize;
+	thiz->count    = that->count;
+	thiz->typesize = that->typesize;
+	that->count    = count;
+	that->typesize = typesize;
+	pool       = thiz->pool;
+	thiz->pool = that->pool;
+	that->pool = pool;
+	cursor             = thiz->cursor;
+	cursor_index       = thiz->cursor_index;
+	thiz->cursor       = that->cursor;
+	thiz->cursor_index = that->cursor_index;
+	that->cursor       = cursor;
+	that->cursor_index = cursor_index;
+	index       = thiz->index;
+	thiz->index = that->index;
+	that->index = index;
+}
+
+/*   move_into: free the items of thiz and take the nodes of that, that becomes empty
+ *   thiz: clist pointer
+ *   that: clist pointer, its pool goes with the nodes, it gets the empty pool of thiz
+ */
+static    void    clist_static_move_into(clist *_thiz, clist *_that) {
+	clist_pool pool;
+	clist_index index;
+	clist_data *thiz = NULL, *that = NULL;
+	if ((_thiz == NULL) || (_that == NULL) || (_thiz == _that)) {
+		return;
+	}
+	thiz = (clist_data*) _thiz;
+	that = (clist_data*) _that;
+	_thiz->clear(_thiz);
+	clist_head_take(&(thiz->head), &(that->head));
+	thiz->count    = that->count;
+	thiz->typesize = that->typesize;
+	that->count    = 0;
+	thiz->cursor       = that->cursor;
+	thiz->cursor_index = that->cursor_index;
+	that->cursor       = NULL;
+	pool       = thiz->pool;
+	thiz->pool = that->pool;
+	that->pool = pool;
+	index       = thiz->index;
+	thiz->index = that->index;
+	that->index = index;
+}
+
 /*   clist_alloc: malloc clist pointer
  *   typesize: clist item size
  *   return: clist pointer
@@ -473,8 +936,18 @@ clist* clist_alloc(uint64_t typesize) {
     
     thiz_data->count = 0;
     thiz_data->typesize  = typesize;
-    thiz_data->head.data = NULL;
     thiz_data->head.next = thiz_data->head.prev = &(thiz_data->head);
+    thiz_data->pool.slabs    = NULL;
+    thiz_data->pool.cells    = NULL;
+    thiz_data->pool.cellsize = 0;
+    thiz_data->pool.enabled  = 0;
+    thiz_data->cursor        = NULL;
+    thiz_data->cursor_index  = 0;
+    thiz_data->index.buckets = NULL;
+    thiz_data->index.mask    = 0;
+    thiz_data->index.hash    = NULL;
+    thiz_data->index.cmp     = NULL;
+    thiz_data->index.enabled = 0;
     thiz = (clist*) &(thiz_data->list);
 
 	thiz->clear = clist_static_clear;
@@ -503,6 +976,45 @@ clist* clist_alloc(uint64_t typesize) {
 	thiz->reverse  = clist_static_reverse;
 	thiz->copy  = clist_static_copy;
 	thiz->equal  = clist_static_equal;
+	thiz->swap  = clist_static_swap;
+	thiz->move_into  = clist_static_move_into;
 
     return thiz;
 }
+
+/*   clist_alloc_pool: malloc clist pointer, nodes come from page sized slabs
+ *   typesize: clist item size
+ *   return: clist pointer
+ */
+clist* clist_alloc_pool(uint64_t typesize) {
+	clist *thiz = clist_alloc(typesize);
+	if (thiz == NULL) {
+		return NULL;
+	}
+	((clist_data *) thiz)->pool.enabled = 1;
+	return thiz;
+}
+
+/*   clist_alloc_hash: malloc clist pointer, find and remove go through a hash index
+ *   typesize: clist item size
+ *   hash: item hash, NULL to hash the item bytes
+ *   cmp:  0 if items are equal, NULL to compare the item bytes
+ *   return: clist pointer
+ */
+clist* clist_alloc_hash(uint64_t typesize, uint64_t (*hash)(const void* val), int (*cmp)(const void* a, const void* b)) {
+	clist *thiz = clist_alloc(typesize);
+	clist_data *thiz_data = (clist_data *) thiz;
+	if (thiz == NULL) {
+		return NULL;
+	}
+	thiz_data->index.buckets = calloc(CLIST_INDEX_BUCKETS, sizeof(clist_node*));
+	if (thiz_data->index.buckets == NULL) {
+		free(thiz_data);
+		return NULL;
+	}
+	thiz_data->index.mask    = CLIST_INDEX_BUCKETS - 1;
+	thiz_data->index.hash    = hash;
+	thiz_data->index.cmp     = cmp;
+	thiz_data->index.enabled = 1;
+	return thiz;
+}
@@ -14,9 +14,9 @@ extern "C"{
 struct clist_node_t;
 typedef struct  clist_node_t  clist_node;
 
-/*   alloc: alloc new node
- *   data: item data pointer
- *   return:  return node pointer
+/*   alloc: alloc new node, the item is stored in the node
+ *   data: item data pointer, NULL leaves the item uninitialized
+ *   return:  return node pointer, NULL if out of memory
  */
 clist_node* clist_node_alloc(uint64_t typesize, const void *data);
 
@@ -33,14 +33,14 @@ clist_node* clist_node_insert(clist_node* head, clist_node* node);
  */
 clist_node* clist_node_erase(clist_node* node);
 
-/*   free: free node
+/*   free: free node, not for the nodes of a clist_alloc_pool or clist_alloc_hash list
  *   node: node pointer
  */
 void        clist_node_free(clist_node *node);
 
 /*   get data: get node data pointer
- *   node: node pointer
- *   return: return data pointer
+ *   node: node pointer, not the list end node
+ *   return: return data pointer, behind the links in the same allocation
  */
 void*       clist_node_data(clist_node* node);
 
@@ -128,10 +128,21 @@ struct clist_t {
  */
     clist_node*     (*rend)(clist *thiz);
 
-
+/*   at: index node pointer, the walk starts from the nearest of head, tail and the last at node
+ *   so at(i) after at(i - 1) or at(i + 1) is one step
+ *   the list functions keep the last at node in step, the clist_node functions do not,
+ *   so do not link or unlink nodes with them while using at
+ *   thiz: clist pointer
+ *   index: item index
+ *   return index node pointer, NULL if index >= size
+ */
     clist_node*     (*at)(clist *thiz, uint64_t index);
 
-
+/*   find: first node of an item equal to val, a hash lookup for clist_alloc_hash lists
+ *   thiz: clist pointer
+ *   val:  item pointer
+ *   return node pointer, NULL if not found
+ */
     clist_node*     (*find)(clist *thiz, const void* val);
 
 /*   push_back: add last item behind 
@@ -186,6 +197,18 @@ struct clist_t {
  *   return: thiz == that
  */
     uint8_t   (*equal)(clist *thiz, clist *that);
+
+/*   swap: exchange the items of thiz and that, no node is copied
+ *   thiz: clist pointer
+ *   that: clist pointer
+ */
+    void      (*swap)(clist *thiz, clist *that);
+
+/*   move_into: free the items of thiz and take the nodes of that, that becomes empty
+ *   thiz: clist pointer
+ *   that: clist pointer
+ */
+    void      (*move_into)(clist *thiz, clist *that);
 };
 
 /*   clist_alloc: malloc clist pointer
@@ -194,6 +217,24 @@ struct clist_t {
  */
 clist* clist_alloc(uint64_t typesize);
 
+/*   clist_alloc_pool: malloc clist pointer, node and item share one cell of a page sized slab
+ *   push and pop reuse free cells, clear and free give the slabs back at once
+ *   typesize: clist item size
+ *   return: clist pointer
+ */
+clist* clist_alloc_pool(uint64_t typesize);
+
+/*   clist_alloc_hash: malloc clist pointer, find and remove are hash lookups, items keep list order
+ *   push, pop, remove and clear keep the index, do not link or unlink nodes with the clist_node functions
+ *   equal items share one index entry, pushing or popping one of many equal items does not walk them
+ *   to key on part of an item, hash and compare only the key bytes and pass an item with the key to find
+ *   typesize: clist item size
+ *   hash: item hash, NULL to hash the item bytes
+ *   cmp:  0 if items are equal, NULL to compare the item bytes
+ *   return: clist pointer
+ */
+clist* clist_alloc_hash(uint64_t typesize, uint64_t (*hash)(const void* val), int (*cmp)(const void* a, const void* b));
+
 
 #ifdef __cplusplus
 }
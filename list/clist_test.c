@@ -39,13 +39,38 @@ static void test_rprint(clist *list) {
     printf("\n");
 }
 
+struct test_pair_t {
+    int key;
+    int value;
+};
+
+static uint64_t test_pair_hash(const void* val) {
+    return ((const struct test_pair_t*) val)->key * 0x9e3779b97f4a7c15ULL;
+}
+
+static int test_pair_cmp(const void* a, const void* b) {
+    return ((const struct test_pair_t*) a)->key - ((const struct test_pair_t*) b)->key;
+}
+
 static void test_list1();
 
 static void test_list2();
 
+static void test_list3();
+
+static void test_list4();
+
+static void test_list5();
+
+static void test_list6();
+
 int main(int argc, const char *argv[]) {
 	test_list1();
 	test_list2();
+	test_list3();
+	test_list4();
+	test_list5();
+	test_list6();
 	return 0;
 }
 
@@ -104,4 +129,169 @@ void test_list2() {
     printf("%d\n", list1->equal(list1, list2));
     list1->free(list1);
     list2->free(list2);
+}
+
+void test_list3() {
+    printf("test swap, move_into\n");
+    int buf[] = {0x21, 0x42, 0x63, 0x84, 0xa5};
+    clist *list1 = clist_alloc(sizeof(int));
+    clist *list2 = clist_alloc(sizeof(int));
+    list1->assign(list1, buf, &buf[5]);
+    list2->push_back(list2, &buf[0]);
+    list1->swap(list1, list2);
+    test_print(list1);
+    test_rprint(list2);
+    list2->push_front(list2, &buf[1]);
+    list1->move_into(list1, list2);
+    test_print(list1);
+    test_print(list2);
+    list2->push_back(list2, &buf[2]);
+    list1->swap(list1, list2);
+    test_rprint(list1);
+    test_print(list2);
+    list1->free(list1);
+    list2->free(list2);
+}
+
+void test_list4() {
+    printf("test alloc_pool\n");
+    int i, sum = 0;
+    clist *list1 = clist_alloc_pool(sizeof(int));
+    clist *list2 = clist_alloc(sizeof(int));
+    for (i = 0 ; i < 1000; ++i) {
+        list1->push_back(list1, &i);
+    }
+    for (i = 0 ; i < 990; ++i) {
+        sum += *((int*)list1->front(list1));
+        list1->pop_front(list1);
+    }
+    i = 995;
+    list1->remove(list1, &i);
+    printf("%d %lld\n", sum, list1->size(list1));
+    list1->clear(list1);
+    for (i = 0 ; i < 5; ++i) {
+        list1->push_back(list1, &i);
+    }
+    list1->copy(list1, list2);
+    list2->pop_front(list2);
+    list1->swap(list1, list2);
+    list1->push_back(list1, &i);
+    list2->push_front(list2, &i);
+    test_print(list1);
+    test_rprint(list2);
+    list1->free(list1);
+    list2->free(list2);
+}
+
+void test_list5() {
+    printf("test at\n");
+    int i, sum = 0;
+    clist *list = clist_alloc(sizeof(int));
+    for (i = 0 ; i < 100; ++i) {
+        list->push_back(list, &i);
+    }
+    for (i = 0 ; i < 100; ++i) {
+        sum += *((int*)clist_node_data(list->at(list, i)));
+    }
+    printf("%d %d\n", sum, list->at(list, 100) == NULL);
+    list->at(list, 50);
+    i = -1;
+    list->push_front(list, &i);
+    printf("%d ", *((int*)clist_node_data(list->at(list, 51))));
+    list->pop_front(list);
+    list->pop_front(list);
+    printf("%d ", *((int*)clist_node_data(list->at(list, 48))));
+    i = 10;
+    list->remove(list, &i);
+    printf("%d ", *((int*)clist_node_data(list->at(list, 47))));
+    i = 48;
+    list->remove(list, &i);
+    printf("%d ", *((int*)clist_node_data(list->at(list, 46))));
+    list->reverse(list);
+    printf("%d ", *((int*)clist_node_data(list->at(list, 50))));
+    list->pop_back(list);
+    printf("%d\n", *((int*)clist_node_data(list->at(list, 95))));
+    list->free(list);
+}
+
+void test_list6() {
+    printf("test alloc_hash\n");
+    int i, hit = 0;
+    struct test_pair_t pair;
+    clist *list  = clist_alloc_hash(sizeof(int), NULL, NULL);
+    clist *list1 = clist_alloc_hash(sizeof(struct test_pair_t), test_pair_hash, test_pair_cmp);
+    for (i = 0 ; i < 100; ++i) {
+        list->push_back(list, &i);
+    }
+    for (i = 0 ; i < 200; ++i) {
+        hit += list->find(list, &i) != NULL;
+    }
+    printf("%d\n", hit);
+    i = 7;
+    list->push_front(list, &i);
+    list->push_back(list, &i);
+    printf("%d ", list->find(list, &i) == list->begin(list));
+    list->remove(list, &i);
+    list->remove(list, &i);
+    printf("%d ", list->find(list, &i) == list->rbegin(list));
+    list->reverse(list);
+    printf("%d ", list->find(list, &i) == list->begin(list));
+    list->pop_front(list);
+    list->pop_back(list);
+    i = 99;
+    printf("%d ", list->find(list, &i) == NULL);
+    i = 0;
+    printf("%d %lld\n", list->find(list, &i) == NULL, list->size(list));
+    list->clear(list);
+    for (i = 0 ; i < 5; ++i) {
+        list->push_front(list, &i);
+    }
+    test_print(list);
+    for (i = 0 ; i < 5; ++i) {
+        pair.key   = i % 3;
+        pair.value = i;
+        list1->push_back(list1, &pair);
+    }
+    pair.key = 1;
+    printf("%d ", ((struct test_pair_t*) clist_node_data(list1->find(list1, &pair)))->value);
+    list1->remove(list1, &pair);
+    printf("%d\n", ((struct test_pair_t*) clist_node_data(list1->find(list1, &pair)))->value);
+    list1->free(list1);
+    list1 = clist_alloc(sizeof(int));
+    list->swap(list, list1);
+    list1->push_back(list1, &i);
+    printf("%d %d\n", list1->find(list1, &i) == list1->rbegin(list1), list->find(list, &i) == NULL);
+    list->free(list);
+    list1->free(list1);
+    // many equal items pushed and popped at both ends, find keeps returning the first one
+    clist_node *it = NULL, *first[3];
+    int ok = 1, removed = 0;
+    list = clist_alloc_hash(sizeof(int), NULL, NULL);
+    for (i = 0 ; i < 30000; ++i) {
+        hit = i % 3;
+        if (i % 2)
+            list->push_back(list, &hit);
+        else
+            list->push_front(list, &hit);
+        if (i % 7 == 0)
+            list->pop_back(list);
+        if (i % 11 == 0)
+            list->pop_front(list);
+    }
+    first[0] = first[1] = first[2] = NULL;
+    for (it = list->begin(list); it != list->end(list); it = clist_node_next(it)) {
+        hit = *((int*) clist_node_data(it));
+        if (first[hit] == NULL)
+            first[hit] = it;
+    }
+    for (hit = 0; hit < 3; ++hit) {
+        ok = ok && (list->find(list, &hit) == first[hit]);
+    }
+    hit = 2;
+    while (list->find(list, &hit) != NULL) {
+        list->remove(list, &hit);
+        ++removed;
+    }
+    printf("%d %d %lld\n", ok, removed, list->size(list));
+    list->free(list);
 }
\ No newline at end of file
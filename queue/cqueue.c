@@ -12,13 +12,98 @@ struct cqueue_node_t {
 };
 
 
+// node pool, page sized slabs cut into cells of node + item, free cells linked through their first word
+// slab
+// +------+--------+--------+-----+
+// | next | cell 0 | cell 1 | ... |
+// +------+--------+--------+-----+
+#define CQUEUE_POOL_SLAB   4096
+#define CQUEUE_POOL_HEAD   16
+
+struct cqueue_pool_t {
+    void*                       slabs;
+    void*                       cells;
+    uint64_t                    cellsize;
+    uint8_t                     enabled;
+};
+
+typedef struct cqueue_pool_t  cqueue_pool;
+
+/*   pool_alloc: take a free cell, carve a new slab when none is left
+ *   pool: pool pointer
+ *   size: cell bytes, kept until the pool is released
+ *   return:  return cell pointer, NULL if out of memory
+ */
+static void*       cqueue_pool_alloc(cqueue_pool *pool, uint64_t size) {
+	uint64_t slabsize, count;
+	void *slab = NULL, *cell = NULL;
+	if (pool->cells == NULL) {
+		if (pool->slabs == NULL)
+			pool->cellsize = (size + 15) & ~((uint64_t) 15);
+		slabsize = CQUEUE_POOL_HEAD + pool->cellsize;
+		if (slabsize < CQUEUE_POOL_SLAB)
+			slabsize = CQUEUE_POOL_SLAB;
+		slab = malloc(slabsize);
+		if (slab == NULL)
+			return NULL;
+		*(void**) slab = pool->slabs;
+		pool->slabs = slab;
+		// link from the back, cells are handed out in address order
+		for (count = (slabsize - CQUEUE_POOL_HEAD) / pool->cellsize; count > 0; --count) {
+			cell = (uint8_t*) slab + CQUEUE_POOL_HEAD + (count - 1) * pool->cellsize;
+			*(void**) cell = pool->cells;
+			pool->cells = cell;
+		}
+	}
+	cell = pool->cells;
+	pool->cells = *(void**) cell;
+	return cell;
+}
+
+/*   pool_free: give a cell back to the pool
+ *   pool: pool pointer
+ *   cell: cell pointer
+ */
+static void        cqueue_pool_free(cqueue_pool *pool, void* cell) {
+	*(void**) cell = pool->cells;
+	pool->cells = cell;
+}
+
+/*   pool_release: free every slab, cells in use too
+ *   pool: pool pointer
+ */
+static void        cqueue_pool_release(cqueue_pool *pool) {
+	void *slab = pool->slabs, *next = NULL;
+	while (slab != NULL) {
+		next = *(void**) slab;
+		free(slab);
+		slab = next;
+	}
+	pool->slabs = NULL;
+	pool->cells = NULL;
+}
+
+// item offset from a pool node, 16 byte aligned as malloc
+#define CQUEUE_NODE_OFFSET   ((sizeof(cqueue_node) + 15) & ~((uint64_t) 15))
+
 /*   alloc: alloc new node
+ *   pool: pool pointer, node and item share one cell when enabled
  *   data: item data pointer
  *   return:  return node pointer
  */
-static cqueue_node* cqueue_node_alloc(uint64_t typesize, const void *data) {
-	cqueue_node* node = malloc(sizeof(cqueue_node));
-    node->data = malloc(typesize);
+static cqueue_node* cqueue_node_alloc(cqueue_pool *pool, uint64_t typesize, const void *data) {
+	cqueue_node* node = NULL;
+	if (pool->enabled) {
+		node = cqueue_pool_alloc(pool, CQUEUE_NODE_OFFSET + typesize);
+		if (node == NULL)
+			return NULL;
+		node->data = (uint8_t*) node + CQUEUE_NODE_OFFSET;
+	} else {
+		node = malloc(sizeof(cqueue_node));
+		if (node == NULL)
+			return NULL;
+		node->data = malloc(typesize);
+	}
     if (data != NULL) {
     	memcpy(node->data, data, typesize);
     }
@@ -51,13 +136,18 @@ static cqueue_node* cqueue_node_erase(cqueue_node* prev, cqueue_node* node) {
 }
 
 /*   free: free node
+ *   pool: pool pointer, the cell goes back to it when enabled
  *   prev: node pointer , node free behind prev
  *   node: node pointer
  */
-static void        cqueue_node_free(cqueue_node* prev, cqueue_node *node) {
+static void        cqueue_node_free(cqueue_pool *pool, cqueue_node* prev, cqueue_node *node) {
 	cqueue_node *next = node->next;
 	prev->next = next;
 	node->next = node;
+	if (pool->enabled) {
+		cqueue_pool_free(pool, node);
+		return;
+	}
 	if (node->data)
 		free(node->data);
 	free(node);
@@ -87,6 +177,7 @@ struct cqueue_data_t {
     cqueue_node                 tail;
     uint64_t                    count;
     uint64_t                    typesize;
+    cqueue_pool                 pool;
 };
 
 typedef struct cqueue_data_t  cqueue_data;
@@ -100,13 +191,21 @@ static    void    cqueue_static_clear(cqueue *thiz) {
 	if (thiz == NULL) 
 		return;
 	thiz_data = (cqueue_data *) thiz;
+	if (thiz_data->pool.enabled) {
+		// nodes live in the slabs, give them back in bulk
+		thiz_data->head.next = &(thiz_data->head);
+		thiz_data->tail.next = &(thiz_data->head);
+		thiz_data->count = 0;
+		cqueue_pool_release(&(thiz_data->pool));
+		return;
+	}
 	if (thiz_data->count <= 0)
 		return;
 	prev = &(thiz_data->head);
 	node = thiz_data->head.next;
 	while(node != &(thiz_data->head)) {
 		next = node->next;
-        cqueue_node_free(prev, node);
+        cqueue_node_free(&(thiz_data->pool), prev, node);
         node = next;
 	}
 	thiz_data->head.next = &(thiz_data->head);
@@ -123,7 +222,8 @@ static    void    cqueue_static_free(cqueue *thiz) {
 	if (thiz == NULL) 
 		return;
 	thiz_data = (cqueue_data *) thiz;
-	if (thiz_data->count <= 0) {
+	if ((thiz_data->count <= 0) || thiz_data->pool.enabled) {
+		cqueue_pool_release(&(thiz_data->pool));
 		free(thiz_data);
 		return;
 	}
@@ -131,7 +231,7 @@ static    void    cqueue_static_free(cqueue *thiz) {
 	node = thiz_data->head.next;
 	while(node != &(thiz_data->head)) {
 		next = node->next;
-        cqueue_node_free(prev, node);
+        cqueue_node_free(&(thiz_data->pool), prev, node);
         node = next;
 	}
 	thiz_data->head.next = &(thiz_data->head);
@@ -202,7 +302,9 @@ static    void    cqueue_static_push(cqueue *thiz, const void* val) {
 	if (thiz == NULL) 
 		return;
 	thiz_data = (cqueue_data *) thiz;
-	node = cqueue_node_alloc(thiz_data->typesize, val);
+	node = cqueue_node_alloc(&(thiz_data->pool), thiz_data->typesize, val);
+	if (node == NULL)
+		return;
 	cqueue_node_insert(thiz_data->tail.next, node);
 	thiz_data->tail.next = node;
 	++thiz_data->count;
@@ -218,7 +320,7 @@ static    void    cqueue_static_pop(cqueue *thiz) {
 	thiz_data = (cqueue_data *) thiz;
 	if (thiz_data->count <= 0)
 		return;
-	cqueue_node_free(&(thiz_data->head), thiz_data->head.next);
+	cqueue_node_free(&(thiz_data->pool), &(thiz_data->head), thiz_data->head.next);
     --thiz_data->count;
     if (thiz_data->count > 0)
     	return;
@@ -243,12 +345,14 @@ static    void    cqueue_static_copy(cqueue *thiz, cqueue *that) {
     that_data->typesize = thiz_data->typesize;
     while (node != &(thiz_data->head)) {
         prev = that_data->tail.next;
-        next = cqueue_node_alloc(thiz_data->typesize, node->data);
+        next = cqueue_node_alloc(&(that_data->pool), thiz_data->typesize, node->data);
+        if (next == NULL)
+        	break;
     	cqueue_node_insert(prev, next);
     	node = node->next;
     	that_data->tail.next = next;
+    	++that_data->count;
     }
-    that_data->count = thiz_data->count;
 }
 
 /*   equal: compare thiz with that
@@ -279,6 +383,73 @@ static    uint8_t    cqueue_static_equal(cqueue *thiz, cqueue *that) {
     return 1;	
 }
 
+/*   take: link the nodes of from behind head, from becomes empty
+ *   head: empty head node
+ *   tail: tail node of head
+ *   from: head node
+ *   from_tail: tail node of from
+ */
+static void        cqueue_head_take(cqueue_node *head, cqueue_node *tail, cqueue_node *from, cqueue_node *from_tail) {
+	if (from->next == from) {
+		head->next = tail->next = head;
+		return;
+	}
+	head->next       = from->next;
+	tail->next       = from_tail->next;
+	tail->next->next = head;
+	from->next = from_tail->next = from;
+}
+
+/*   swap: exchange the items of thiz and that, no node is copied, the pools go with the nodes
+ *   thiz: cqueue pointer
+ *   that: cqueue pointer
+ */
+static    void    cqueue_static_swap(cqueue *thiz, cqueue *that) {
+	cqueue_node head, tail;
+	cqueue_pool pool;
+	uint64_t count, typesize;
+	cqueue_data *thiz_data = NULL, *that_data = NULL;
+	if ((thiz == NULL) || (that == NULL) || (thiz == that)) {
+		return;
+	}
+	thiz_data = (cqueue_data *) thiz;
+	that_data = (cqueue_data *) that;
+	cqueue_head_take(&head, &tail, &(thiz_data->head), &(thiz_data->tail));
+	cqueue_head_take(&(thiz_data->head), &(thiz_data->tail), &(that_data->head), &(that_data->tail));
+	cqueue_head_take(&(that_data->head), &(that_data->tail), &head, &tail);
+	count    = thiz_data->count;
+	typesize = thiz_data->typesize;
+	thiz_data->count    = that_data->count;
+	thiz_data->typesize = that_data->typesize;
+	that_data->count    = count;
+	that_data->typesize = typesize;
+	pool            = thiz_data->pool;
+	thiz_data->pool = that_data->pool;
+	that_data->pool = pool;
+}
+
+/*   move_into: free the items of thiz and take the nodes of that, that becomes empty
+ *   thiz: cqueue pointer
+ *   that: cqueue pointer, its pool goes with the nodes, it gets the empty pool of thiz
+ */
+static    void    cqueue_static_move_into(cqueue *thiz, cqueue *that) {
+	cqueue_pool pool;
+	cqueue_data *thiz_data = NULL, *that_data = NULL;
+	if ((thiz == NULL) || (that == NULL) || (thiz == that)) {
+		return;
+	}
+	thiz_data = (cqueue_data *) thiz;
+	that_data = (cqueue_data *) that;
+	thiz->clear(thiz);
+	cqueue_head_take(&(thiz_data->head), &(thiz_data->tail), &(that_data->head), &(that_data->tail));
+	thiz_data->count    = that_data->count;
+	thiz_data->typesize = that_data->typesize;
+	that_data->count    = 0;
+	pool            = thiz_data->pool;
+	thiz_data->pool = that_data->pool;
+	that_data->pool = pool;
+}
+
 /*   cqueue_alloc: malloc cqueue pointer
  *   typesize: cqueue item size
  *   return: cqueue pointer
@@ -301,6 +472,10 @@ cqueue* cqueue_alloc(uint64_t typesize) {
     thiz_data->head.data = NULL;
     thiz_data->tail.next = &(thiz_data->head);
     thiz_data->tail.data = NULL;
+    thiz_data->pool.slabs    = NULL;
+    thiz_data->pool.cells    = NULL;
+    thiz_data->pool.cellsize = 0;
+    thiz_data->pool.enabled  = 0;
 
     thiz = (cqueue *) &(thiz_data->queue);
 
@@ -315,6 +490,21 @@ cqueue* cqueue_alloc(uint64_t typesize) {
 	thiz->pop    = cqueue_static_pop;
 	thiz->copy   = cqueue_static_copy;
 	thiz->equal  = cqueue_static_equal;
+	thiz->swap   = cqueue_static_swap;
+	thiz->move_into  = cqueue_static_move_into;
 
     return thiz;
 }
+
+/*   cqueue_alloc_pool: malloc cqueue pointer, nodes come from page sized slabs
+ *   typesize: cqueue item size
+ *   return: cqueue pointer
+ */
+cqueue* cqueue_alloc_pool(uint64_t typesize) {
+	cqueue *thiz = cqueue_alloc(typesize);
+	if (thiz == NULL) {
+		return NULL;
+	}
+	((cqueue_data *) thiz)->pool.enabled = 1;
+	return thiz;
+}
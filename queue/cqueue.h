@@ -74,6 +74,18 @@ struct cqueue_t {
  *   return: thiz == that
  */
     uint8_t   (*equal)(cqueue *thiz, cqueue *that);
+
+/*   swap: exchange the items of thiz and that, no node is copied
+ *   thiz: cqueue pointer
+ *   that: cqueue pointer
+ */
+    void      (*swap)(cqueue *thiz, cqueue *that);
+
+/*   move_into: free the items of thiz and take the nodes of that, that becomes empty
+ *   thiz: cqueue pointer
+ *   that: cqueue pointer
+ */
+    void      (*move_into)(cqueue *thiz, cqueue *that);
 };
 
 /*   cqueue_alloc: malloc cqueue pointer
@@ -82,6 +94,13 @@ struct cqueue_t {
  */
 cqueue* cqueue_alloc(uint64_t typesize);
 
+/*   cqueue_alloc_pool: malloc cqueue pointer, node and item share one cell of a page sized slab
+ *   push and pop reuse free cells, clear and free give the slabs back at once
+ *   typesize: cqueue item size
+ *   return: cqueue pointer
+ */
+cqueue* cqueue_alloc_pool(uint64_t typesize);
+
 
 #ifdef __cplusplus
 }
@@ -22,9 +22,15 @@ static void test_queue1();
 
 static void test_queue2();
 
+static void test_queue3();
+
+static void test_queue4();
+
 int main(int argc, const char *argv[]) {
 	test_queue1();
 	test_queue2();
+	test_queue3();
+	test_queue4();
 	return 0;
 }
 
@@ -54,4 +60,53 @@ void test_queue1() {
 
 void test_queue2() {
 
+}
+
+void test_queue3() {
+    printf("test swap, move_into\n");
+    int buf[] = {0x01, 0x12, 0x23, 0x34, 0x45};
+    cqueue *queue  = cqueue_alloc(sizeof(int));
+    cqueue *queue1 = cqueue_alloc(sizeof(int));
+    for (int i = 0 ; i < 5; ++i) {
+        queue->push(queue, &buf[i]);
+    }
+    queue->swap(queue, queue1);
+    printf("%lld %lld\n", queue->size(queue), queue1->size(queue1));
+    queue1->push(queue1, &buf[0]);
+    queue->move_into(queue, queue1);
+    printf("%d\n", queue1->empty(queue1));
+    queue1->push(queue1, &buf[2]);
+    queue->push(queue, &buf[1]);
+    test_print(queue);
+    test_print(queue1);
+    queue->free(queue);
+    queue1->free(queue1);
+}
+
+void test_queue4() {
+    printf("test alloc_pool\n");
+    int i, sum = 0;
+    cqueue *queue  = cqueue_alloc_pool(sizeof(int));
+    cqueue *queue1 = cqueue_alloc(sizeof(int));
+    for (i = 0 ; i < 1000; ++i) {
+        queue->push(queue, &i);
+    }
+    for (i = 0 ; i < 990; ++i) {
+        sum += *((int*)queue->front(queue));
+        queue->pop(queue);
+    }
+    printf("%d %lld\n", sum, queue->size(queue));
+    queue->clear(queue);
+    for (i = 0 ; i < 5; ++i) {
+        queue->push(queue, &i);
+    }
+    queue->copy(queue, queue1);
+    queue1->pop(queue1);
+    queue->swap(queue, queue1);
+    queue->push(queue, &i);
+    queue1->push(queue1, &i);
+    test_print(queue);
+    test_print(queue1);
+    queue->free(queue);
+    queue1->free(queue1);
 }
\ No newline at end of file
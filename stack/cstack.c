@@ -12,13 +12,98 @@ struct cstack_node_t {
 };
 
 
+// node pool, page sized slabs cut into cells of node + item, free cells linked through their first word
+// slab
+// +------+--------+--------+-----+
+// | next | cell 0 | cell 1 | ... |
+// +------+--------+--------+-----+
+#define CSTACK_POOL_SLAB   4096
+#define CSTACK_POOL_HEAD   16
+
+struct cstack_pool_t {
+    void*                       slabs;
+    void*                       cells;
+    uint64_t                    cellsize;
+    uint8_t                     enabled;
+};
+
+typedef struct cstack_pool_t  cstack_pool;
+
+/*   pool_alloc: take a free cell, carve a new slab when none is left
+ *   pool: pool pointer
+ *   size: cell bytes, kept until the pool is released
+ *   return:  return cell pointer, NULL if out of memory
+ */
+static void*       cstack_pool_alloc(cstack_pool *pool, uint64_t size) {
+	uint64_t slabsize, count;
+	void *slab = NULL, *cell = NULL;
+	if (pool->cells == NULL) {
+		if (pool->slabs == NULL)
+			pool->cellsize = (size + 15) & ~((uint64_t) 15);
+		slabsize = CSTACK_POOL_HEAD + pool->cellsize;
+		if (slabsize < CSTACK_POOL_SLAB)
+			slabsize = CSTACK_POOL_SLAB;
+		slab = malloc(slabsize);
+		if (slab == NULL)
+			return NULL;
+		*(void**) slab = pool->slabs;
+		pool->slabs = slab;
+		// link from the back, cells are handed out in address order
+		for (count = (slabsize - CSTACK_POOL_HEAD) / pool->cellsize; count > 0; --count) {
+			cell = (uint8_t*) slab + CSTACK_POOL_HEAD + (count - 1) * pool->cellsize;
+			*(void**) cell = pool->cells;
+			pool->cells = cell;
+		}
+	}
+	cell = pool->cells;
+	pool->cells = *(void**) cell;
+	return cell;
+}
+
+/*   pool_free: give a cell back to the pool
+ *   pool: pool pointer
+ *   cell: cell pointer
+ */
+static void        cstack_pool_free(cstack_pool *pool, void* cell) {
+	*(void**) cell = pool->cells;
+	pool->cells = cell;
+}
+
+/*   pool_release: free every slab, cells in use too
+ *   pool: pool pointer
+ */
+static void        cstack_pool_release(cstack_pool *pool) {
+	void *slab = pool->slabs, *next = NULL;
+	while (slab != NULL) {
+		next = *(void**) slab;
+		free(slab);
+		slab = next;
+	}
+	pool->slabs = NULL;
+	pool->cells = NULL;
+}
+
+// item offset from a pool node, 16 byte aligned as malloc
+#define CSTACK_NODE_OFFSET   ((sizeof(cstack_node) + 15) & ~((uint64_t) 15))
+
 /*   alloc: alloc new node
+ *   pool: pool pointer, node and item share one cell when enabled
  *   data: item data pointer
  *   return:  return node pointer
  */
-static cstack_node* cstack_node_alloc(uint64_t typesize, const void *data) {
-	cstack_node* node = malloc(sizeof(cstack_node));
-    node->data = malloc(typesize);
+static cstack_node* cstack_node_alloc(cstack_pool *pool, uint64_t typesize, const void *data) {
+	cstack_node* node = NULL;
+	if (pool->enabled) {
+		node = cstack_pool_alloc(pool, CSTACK_NODE_OFFSET + typesize);
+		if (node == NULL)
+			return NULL;
+		node->data = (uint8_t*) node + CSTACK_NODE_OFFSET;
+	} else {
+		node = malloc(sizeof(cstack_node));
+		if (node == NULL)
+			return NULL;
+		node->data = malloc(typesize);
+	}
     if (data != NULL) {
     	memcpy(node->data, data, typesize);
     }
@@ -51,13 +136,18 @@ static cstack_node* cstack_node_erase(cstack_node* prev, cstack_node* node) {
 }
 
 /*   free: free node
+ *   pool: pool pointer, the cell goes back to it when enabled
  *   prev: node pointer , node free behind prev
  *   node: node pointer
  */
-static void        cstack_node_free(cstack_node* prev, cstack_node *node) {
+static void        cstack_node_free(cstack_pool *pool, cstack_node* prev, cstack_node *node) {
 	cstack_node *next = node->next;
 	prev->next = next;
 	node->next = node;
+	if (pool->enabled) {
+		cstack_pool_free(pool, node);
+		return;
+	}
 	if (node->data)
 		free(node->data);
 	free(node);
@@ -84,8 +174,10 @@ static cstack_node* cstack_node_next(cstack_node* node) {
 struct cstack_data_t {
 	cstack                      stack;
     cstack_node                 topped;
+    cstack_node                 bottom;
     uint64_t                    count;
     uint64_t                    typesize;
+    cstack_pool                 pool;
 };
 
 typedef struct cstack_data_t  cstack_data;
@@ -100,16 +192,25 @@ static    void    cstack_static_clear(cstack *_thiz) {
 	if (_thiz == NULL) 
 		return;
 	thiz = (cstack_data*) _thiz;
+	if (thiz->pool.enabled) {
+		// nodes live in the slabs, give them back in bulk
+		thiz->topped.next = &(thiz->topped);
+		thiz->bottom.next = &(thiz->topped);
+		thiz->count = 0;
+		cstack_pool_release(&(thiz->pool));
+		return;
+	}
 	if (thiz->count <= 0)
 		return;
 	prev = &(thiz->topped);
 	node = thiz->topped.next;
 	while(node != &(thiz->topped)) {
 		next = node->next;
-        cstack_node_free(prev, node);
+        cstack_node_free(&(thiz->pool), prev, node);
         node = next;
 	}
 	thiz->topped.next = &(thiz->topped);
+	thiz->bottom.next = &(thiz->topped);
     thiz->count = 0;
 }
 
@@ -122,7 +223,8 @@ static    void    cstack_static_free(cstack *_thiz) {
 	if (_thiz == NULL) 
 		return;
 	thiz = (cstack_data*) _thiz;
-	if (thiz->count <= 0) {
+	if ((thiz->count <= 0) || thiz->pool.enabled) {
+		cstack_pool_release(&(thiz->pool));
 		free(thiz);
 		return;
 	}
@@ -130,10 +232,11 @@ static    void    cstack_static_free(cstack *_thiz) {
 	node = thiz->topped.next;
 	while(node != &(thiz->topped)) {
 		next = node->next;
-        cstack_node_free(prev, node);
+        cstack_node_free(&(thiz->pool), prev, node);
         node = next;
 	}
 	thiz->topped.next = &(thiz->topped);
+	thiz->bottom.next = &(thiz->topped);
     thiz->count = 0;
 	free(thiz);
 }
@@ -200,8 +303,12 @@ static    void    cstack_static_push(cstack *_thiz, const void* val) {
 	if ((_thiz == NULL) || (val == NULL))
 		return;
 	thiz = (cstack_data*) _thiz;
-	node = cstack_node_alloc(thiz->typesize, val);
+	node = cstack_node_alloc(&(thiz->pool), thiz->typesize, val);
+	if (node == NULL)
+		return;
 	cstack_node_insert(&(thiz->topped), node);
+	if (thiz->count <= 0)
+		thiz->bottom.next = node;
 	++thiz->count;
 }
 
@@ -215,8 +322,10 @@ static    void    cstack_static_pop(cstack *_thiz) {
 	thiz = (cstack_data*) _thiz;
 	if (thiz->count <= 0)
 		return;
-	cstack_node_free(&(thiz->topped), thiz->topped.next);
+	cstack_node_free(&(thiz->pool), &(thiz->topped), thiz->topped.next);
     --thiz->count;
+    if (thiz->count <= 0)
+    	thiz->bottom.next = &(thiz->topped);
 }
 
 /*   copy: copy value from thiz to that
@@ -224,7 +333,7 @@ static    void    cstack_static_pop(cstack *_thiz) {
  *   that: cstack pointer
  */
 static    void    cstack_static_copy(cstack *_thiz, cstack *_that) {
-	cstack_node *node = NULL, *next = NULL;
+	cstack_node *node = NULL, *next = NULL, *item = NULL;
 	cstack_data *thiz = NULL, *that = NULL;
 	if ((_thiz == NULL) || (_that == NULL)) {
 		return;
@@ -236,11 +345,15 @@ static    void    cstack_static_copy(cstack *_thiz, cstack *_that) {
     that->typesize = thiz->typesize;
     next = that->topped.next;
     while (node != &(thiz->topped)) {
-    	cstack_node_insert(next, cstack_node_alloc(thiz->typesize, node->data));
+    	item = cstack_node_alloc(&(that->pool), thiz->typesize, node->data);
+    	if (item == NULL)
+    		break;
+    	cstack_node_insert(next, item);
     	node = node->next;
     	next = next->next;
+    	++that->count;
     }
-    that->count = thiz->count;
+    that->bottom.next = next;
 }
 
 /*   equal: compare thiz with that
@@ -271,6 +384,73 @@ static    uint8_t    cstack_static_equal(cstack *_thiz, cstack *_that) {
     return 1;	
 }
 
+/*   take: link the nodes of from behind topped, from becomes empty
+ *   topped: empty top node
+ *   bottom: bottom node of topped
+ *   from:   top node
+ *   from_bottom: bottom node of from
+ */
+static void        cstack_topped_take(cstack_node *topped, cstack_node *bottom, cstack_node *from, cstack_node *from_bottom) {
+	if (from->next == from) {
+		topped->next = bottom->next = topped;
+		return;
+	}
+	topped->next       = from->next;
+	bottom->next       = from_bottom->next;
+	bottom->next->next = topped;
+	from->next = from_bottom->next = from;
+}
+
+/*   swap: exchange the items of thiz and that, no node is copied, the pools go with the nodes
+ *   thiz: cstack pointer
+ *   that: cstack pointer
+ */
+static    void    cstack_static_swap(cstack *_thiz, cstack *_that) {
+	cstack_node topped, bottom;
+	cstack_pool pool;
+	uint64_t count, typesize;
+	cstack_data *thiz = NULL, *that = NULL;
+	if ((_thiz == NULL) || (_that == NULL) || (_thiz == _that)) {
+		return;
+	}
+	thiz = (cstack_data*) _thiz;
+	that = (cstack_data*) _that;
+	cstack_topped_take(&topped, &bottom, &(thiz->topped), &(thiz->bottom));
+	cstack_topped_take(&(thiz->topped), &(thiz->bottom), &(that->topped), &(that->bottom));
+	cstack_topped_take(&(that->topped), &(that->bottom), &topped, &bottom);
+	count          = thiz->count;
+	typesize       = thiz->typesize;
+	thiz->count    = that->count;
+	thiz->typesize = that->typesize;
+	that->count    = count;
+	that->typesize = typesize;
+	pool       = thiz->pool;
+	thiz->pool = that->pool;
+	that->pool = pool;
+}
+
+/*   move_into: free the items of thiz and take the nodes of that, that becomes empty
+ *   thiz: cstack pointer
+ *   that: cstack pointer, its pool goes with the nodes, it gets the empty pool of thiz
+ */
+static    void    cstack_static_move_into(cstack *_thiz, cstack *_that) {
+	cstack_pool pool;
+	cstack_data *thiz = NULL, *that = NULL;
+	if ((_thiz == NULL) || (_that == NULL) || (_thiz == _that)) {
+		return;
+	}
+	thiz = (cstack_data*) _thiz;
+	that = (cstack_data*) _that;
+	_thiz->clear(_thiz);
+	cstack_topped_take(&(thiz->topped), &(thiz->bottom), &(that->topped), &(that->bottom));
+	thiz->count    = that->count;
+	thiz->typesize = that->typesize;
+	that->count    = 0;
+	pool       = thiz->pool;
+	thiz->pool = that->pool;
+	that->pool = pool;
+}
+
 /*   cstack_alloc: malloc cstack pointer
  *   typesize: cstack item size
  *   return: cstack pointer
@@ -291,6 +471,12 @@ cstack* cstack_alloc(uint64_t typesize) {
     thiz_data->count    = 0;
     thiz_data->topped.next = &(thiz_data->topped);
     thiz_data->topped.data = NULL;
+    thiz_data->bottom.next = &(thiz_data->topped);
+    thiz_data->bottom.data = NULL;
+    thiz_data->pool.slabs    = NULL;
+    thiz_data->pool.cells    = NULL;
+    thiz_data->pool.cellsize = 0;
+    thiz_data->pool.enabled  = 0;
 
     thiz = (cstack *) &(thiz_data->stack);
 
@@ -305,6 +491,21 @@ cstack* cstack_alloc(uint64_t typesize) {
 	thiz->pop    = cstack_static_pop;
 	thiz->copy   = cstack_static_copy;
 	thiz->equal  = cstack_static_equal;
+	thiz->swap   = cstack_static_swap;
+	thiz->move_into  = cstack_static_move_into;
 
     return thiz;
 }
+
+/*   cstack_alloc_pool: malloc cstack pointer, nodes come from page sized slabs
+ *   typesize: cstack item size
+ *   return: cstack pointer
+ */
+cstack* cstack_alloc_pool(uint64_t typesize) {
+	cstack *thiz = cstack_alloc(typesize);
+	if (thiz == NULL) {
+		return NULL;
+	}
+	((cstack_data *) thiz)->pool.enabled = 1;
+	return thiz;
+}
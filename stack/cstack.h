@@ -77,6 +77,18 @@ struct cstack_t {
  */
     uint8_t   (*equal)(cstack *thiz, cstack *that);
 
+/*   swap: exchange the items of thiz and that, no node is copied
+ *   thiz: cstack pointer
+ *   that: cstack pointer
+ */
+    void      (*swap)(cstack *thiz, cstack *that);
+
+/*   move_into: free the items of thiz and take the nodes of that, that becomes empty
+ *   thiz: cstack pointer
+ *   that: cstack pointer
+ */
+    void      (*move_into)(cstack *thiz, cstack *that);
+
 };
 
 /*   cstack_alloc: malloc cstack pointer
@@ -85,6 +97,13 @@ struct cstack_t {
  */
 cstack* cstack_alloc(uint64_t typesize);
 
+/*   cstack_alloc_pool: malloc cstack pointer, node and item share one cell of a page sized slab
+ *   push and pop reuse free cells, clear and free give the slabs back at once
+ *   typesize: cstack item size
+ *   return: cstack pointer
+ */
+cstack* cstack_alloc_pool(uint64_t typesize);
+
 
 #ifdef __cplusplus
 }
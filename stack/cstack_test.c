@@ -22,9 +22,15 @@ static void test_stack1();
 
 static void test_stack2();
 
+static void test_stack3();
+
+static void test_stack4();
+
 int main(int argc, const char *argv[]) {
 	test_stack1();
 	test_stack2();
+	test_stack3();
+	test_stack4();
 	return 0;
 }
 
@@ -50,4 +56,54 @@ void test_stack1() {
 
 void test_stack2() {
 
+}
+
+void test_stack3() {
+    printf("test swap, move_into\n");
+    int buf[] = {0x01, 0x12, 0x23, 0x34, 0x45};
+    cstack *stack  = cstack_alloc(sizeof(int));
+    cstack *stack1 = cstack_alloc(sizeof(int));
+    for (int i = 0 ; i < 5; ++i) {
+        stack->push(stack, &buf[i]);
+    }
+    stack->swap(stack, stack1);
+    printf("%lld %lld\n", stack->size(stack), stack1->size(stack1));
+    stack->push(stack, &buf[0]);
+    stack->move_into(stack, stack1);
+    stack1->push(stack1, &buf[2]);
+    stack1->swap(stack1, stack);
+    stack->pop(stack);
+    stack1->push(stack1, &buf[1]);
+    test_print(stack);
+    test_print(stack1);
+    stack->free(stack);
+    stack1->free(stack1);
+}
+
+void test_stack4() {
+    printf("test alloc_pool\n");
+    int i, sum = 0;
+    cstack *stack  = cstack_alloc_pool(sizeof(int));
+    cstack *stack1 = cstack_alloc(sizeof(int));
+    for (i = 0 ; i < 1000; ++i) {
+        stack->push(stack, &i);
+    }
+    for (i = 0 ; i < 990; ++i) {
+        sum += *((int*)stack->top(stack));
+        stack->pop(stack);
+    }
+    printf("%d %lld\n", sum, stack->size(stack));
+    stack->clear(stack);
+    for (i = 0 ; i < 5; ++i) {
+        stack->push(stack, &i);
+    }
+    stack->copy(stack, stack1);
+    stack1->pop(stack1);
+    stack->swap(stack, stack1);
+    stack->push(stack, &i);
+    stack1->push(stack1, &i);
+    test_print(stack);
+    test_print(stack1);
+    stack->free(stack);
+    stack1->free(stack1);
 }
\ No newline at end of file
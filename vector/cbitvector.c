@@ -0,0 +1,671 @@
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CBITVECTOR_X86  1
+#endif
+#include "cbitvector.h"
+
+// words per rank block, the rank directory holds one count per block
+#define CBITVECTOR_BLOCK  8
+
+struct cbitvector_data_t {
+	cbitvector                 vector;
+    uint64_t*                  words;
+    uint64_t                   size;
+    uint64_t                   capacity;
+    uint64_t*                  ranks;
+    uint64_t                   rank_count;
+    uint8_t                    rank_valid;
+};
+
+typedef struct cbitvector_data_t  cbitvector_data;
+
+
+/*   word kernels, scalar for any cpu
+ */
+static    uint64_t    cbitvector_popcount_scalar(const uint64_t* words, uint64_t n) {
+	uint64_t i, count = 0;
+	for (i = 0; i < n; ++i)
+		count += __builtin_popcountll(words[i]);
+	return count;
+}
+
+#define CBITVECTOR_OP_SCALAR(NAME, EXPR)                                                       \
+static    void    cbitvector_##NAME##_scalar(uint64_t* dst, const uint64_t* src, uint64_t n) { \
+	uint64_t i;                                                                                \
+	for (i = 0; i < n; ++i)                                                                    \
+		dst[i] = EXPR;                                                                         \
+}
+
+CBITVECTOR_OP_SCALAR(and,    dst[i] & src[i])
+CBITVECTOR_OP_SCALAR(or,     dst[i] | src[i])
+CBITVECTOR_OP_SCALAR(xor,    dst[i] ^ src[i])
+CBITVECTOR_OP_SCALAR(andnot, dst[i] & ~src[i])
+
+struct cbitvector_kernel_t {
+    uint64_t     (*popcount)(const uint64_t* words, uint64_t n);
+    void         (*bit_and)(uint64_t* dst, const uint64_t* src, uint64_t n);
+    void         (*bit_or)(uint64_t* dst, const uint64_t* src, uint64_t n);
+    void         (*bit_xor)(uint64_t* dst, const uint64_t* src, uint64_t n);
+    void         (*bit_andnot)(uint64_t* dst, const uint64_t* src, uint64_t n);
+};
+
+typedef struct cbitvector_kernel_t  cbitvector_kernel;
+
+static const cbitvector_kernel cbitvector_kernel_scalar = {
+	cbitvector_popcount_scalar, cbitvector_and_scalar, cbitvector_or_scalar, cbitvector_xor_scalar, cbitvector_andnot_scalar,
+};
+
+#ifdef CBITVECTOR_X86
+
+// popcnt instruction, four independent sums
+static __attribute__((target("popcnt"))) uint64_t    cbitvector_popcount_popcnt(const uint64_t* words, uint64_t n) {
+	uint64_t i = 0, c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+	for (; i + 4 <= n; i += 4) {
+		c0 += __builtin_popcountll(words[i]);
+		c1 += __builtin_popcountll(words[i + 1]);
+		c2 += __builtin_popcountll(words[i + 2]);
+		c3 += __builtin_popcountll(words[i + 3]);
+	}
+	for (; i < n; ++i)
+		c0 += __builtin_popcountll(words[i]);
+	return c0 + c1 + c2 + c3;
+}
+
+// nibble lookup with pshufb, byte counts summed with sad every 31 rounds before they overflow
+static __attribute__((target("avx2,popcnt"))) uint64_t    cbitvector_popcount_avx2(const uint64_t* words, uint64_t n) {
+	const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+	                                        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+	const __m256i low = _mm256_set1_epi8(0x0f);
+	__m256i total = _mm256_setzero_si256(), local, v;
+	uint64_t i = 0, j, count;
+	while (i + 4 <= n) {
+		local = _mm256_setzero_si256();
+		for (j = 0; (j < 31) && (i + 4 <= n); ++j, i += 4) {
+			v = _mm256_loadu_si256((const __m256i*) (words + i));
+			local = _mm256_add_epi8(local, _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low)));
+			local = _mm256_add_epi8(local, _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low)));
+		}
+		total = _mm256_add_epi64(total, _mm256_sad_epu8(local, _mm256_setzero_si256()));
+	}
+	count = (uint64_t) _mm256_extract_epi64(total, 0) + (uint64_t) _mm256_extract_epi64(total, 1)
+	      + (uint64_t) _mm256_extract_epi64(total, 2) + (uint64_t) _mm256_extract_epi64(total, 3);
+	for (; i < n; ++i)
+		count += __builtin_popcountll(words[i]);
+	return count;
+}
+
+#define CBITVECTOR_OP_AVX2(NAME, VEXPR, EXPR)                                                  \
+static __attribute__((target("avx2"))) void    cbitvector_##NAME##_avx2(uint64_t* dst, const uint64_t* src, uint64_t n) { \
+	uint64_t i = 0;                                                                            \
+	__m256i a, b;                                                                              \
+	for (; i + 4 <= n; i += 4) {                                                               \
+		a = _mm256_loadu_si256((const __m256i*) (dst + i));                                    \
+		b = _mm256_loadu_si256((const __m256i*) (src + i));                                    \
+		_mm256_storeu_si256((__m256i*) (dst + i), VEXPR);                                      \
+	}                                                                                          \
+	for (; i < n; ++i)                                                                         \
+		dst[i] = EXPR;                                                                         \
+}
+
+CBITVECTOR_OP_AVX2(and,    _mm256_and_si256(a, b),    dst[i] & src[i])
+CBITVECTOR_OP_AVX2(or,     _mm256_or_si256(a, b),     dst[i] | src[i])
+CBITVECTOR_OP_AVX2(xor,    _mm256_xor_si256(a, b),    dst[i] ^ src[i])
+CBITVECTOR_OP_AVX2(andnot, _mm256_andnot_si256(b, a), dst[i] & ~src[i])
+
+static const cbitvector_kernel cbitvector_kernel_popcnt = {
+	cbitvector_popcount_popcnt, cbitvector_and_scalar, cbitvector_or_scalar, cbitvector_xor_scalar, cbitvector_andnot_scalar,
+};
+
+static const cbitvector_kernel cbitvector_kernel_avx2 = {
+	cbitvector_popcount_avx2, cbitvector_and_avx2, cbitvector_or_avx2, cbitvector_xor_avx2, cbitvector_andnot_avx2,
+};
+
+#endif
+
+static    const cbitvector_kernel    *cbitvector_kernel_chosen = NULL;
+
+static    pthread_once_t    cbitvector_kernel_once = PTHREAD_ONCE_INIT;
+
+/*   kernel_init: choose the word kernels by cpu, run once
+ */
+static    void    cbitvector_kernel_init() {
+	cbitvector_kernel_chosen = &cbitvector_kernel_scalar;
+#ifdef CBITVECTOR_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+		cbitvector_kernel_chosen = &cbitvector_kernel_avx2;
+	else if (__builtin_cpu_supports("popcnt"))
+		cbitvector_kernel_chosen = &cbitvector_kernel_popcnt;
+#endif
+}
+
+/*   kernel: word kernels, chosen once under pthread_once
+ *   return kernel pointer
+ */
+static    const cbitvector_kernel*    cbitvector_kernel_get() {
+	pthread_once(&cbitvector_kernel_once, cbitvector_kernel_init);
+	return cbitvector_kernel_chosen;
+}
+
+/*   word_count: words holding bits
+ *   bits: bit count
+ *   return word count
+ */
+static inline uint64_t    cbitvector_word_count(uint64_t bits) {
+	return (bits + 63) / 64;
+}
+
+/*   tail_trim: set the bits behind size in the last word to 0
+ *   thiz: cbitvector data pointer
+ */
+static inline void    cbitvector_tail_trim(cbitvector_data *thiz) {
+	if (thiz->size % 64 != 0)
+		thiz->words[thiz->size / 64] &= (1ULL << (thiz->size % 64)) - 1;
+}
+
+/*   words_grow: realloc words until capacity bits fit, new words are 0
+ *   thiz: cbitvector data pointer
+ *   capacity: bit count
+ *   return 0 if success, -1 if out of memory
+ */
+static    int    cbitvector_words_grow(cbitvector_data *thiz, uint64_t capacity) {
+	uint64_t count = cbitvector_word_count(capacity);
+	uint64_t* ptr = NULL;
+	if (count <= thiz->capacity)
+		return 0;
+	ptr = (uint64_t*) realloc(thiz->words, count * sizeof(uint64_t));
+	if (ptr == NULL)
+		return -1;
+	memset(ptr + thiz->capacity, 0, (count - thiz->capacity) * sizeof(uint64_t));
+	thiz->words    = ptr;
+	thiz->capacity = count;
+	return 0;
+}
+
+/*   rank_build: count 1 bits before every block
+ *   thiz: cbitvector data pointer
+ *   return 0 if success, -1 if out of memory
+ */
+static    int    cbitvector_rank_build(cbitvector_data *thiz) {
+	uint64_t b, words, blocks, count = 0;
+	uint64_t* ptr = NULL;
+	const cbitvector_kernel *kernel = cbitvector_kernel_get();
+	if (thiz->rank_valid)
+		return 0;
+	words  = cbitvector_word_count(thiz->size);
+	blocks = words / CBITVECTOR_BLOCK + 1;
+	if (blocks > thiz->rank_count) {
+		ptr = (uint64_t*) realloc(thiz->ranks, blocks * sizeof(uint64_t));
+		if (ptr == NULL)
+			return -1;
+		thiz->ranks      = ptr;
+		thiz->rank_count = blocks;
+	}
+	for (b = 0; b < blocks; ++b) {
+		thiz->ranks[b] = count;
+		if (b * CBITVECTOR_BLOCK < words)
+			count += kernel->popcount(thiz->words + b * CBITVECTOR_BLOCK,
+			                          (words - b * CBITVECTOR_BLOCK < CBITVECTOR_BLOCK) ? words - b * CBITVECTOR_BLOCK : CBITVECTOR_BLOCK);
+	}
+	thiz->rank_valid = 1;
+	return 0;
+}
+
+
+/*   clear: clear data, but not free
+ *   thiz: cbitvector pointer
+ */
+static    void    cbitvector_static_clear(cbitvector *_thiz) {
+	cbitvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return;
+	thiz = (cbitvector_data*) _thiz;
+	memset(thiz->words, 0, cbitvector_word_count(thiz->size) * sizeof(uint64_t));
+	thiz->size       = 0;
+	thiz->rank_valid = 0;
+}
+
+/*   free: free thiz and words
+ *   thiz: cbitvector pointer
+ */
+static    void    cbitvector_static_free(cbitvector *_thiz) {
+	cbitvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return;
+	thiz = (cbitvector_data*) _thiz;
+	free(thiz->words);
+	free(thiz->ranks);
+	free(thiz);
+}
+
+/*   size: get bit count
+ *   thiz: cbitvector pointer
+ *   return  bit count
+ */
+static uint64_t    cbitvector_static_size(cbitvector *_thiz) {
+	if (_thiz == NULL)
+		return 0;
+	return ((cbitvector_data*) _thiz)->size;
+}
+
+/*   capacity: get bit count the words hold
+ *   thiz: cbitvector pointer
+ *   return  max bit count
+ */
+static uint64_t    cbitvector_static_capacity(cbitvector *_thiz) {
+	if (_thiz == NULL)
+		return 0;
+	return ((cbitvector_data*) _thiz)->capacity * 64;
+}
+
+/*   empty: bit count == 0
+ *   thiz: cbitvector pointer
+ *   return  bit count == 0
+ */
+static uint8_t    cbitvector_static_empty(cbitvector *_thiz) {
+	if (_thiz == NULL)
+		return 0;
+	return (((cbitvector_data*) _thiz)->size == 0) ? 1 : 0;
+}
+
+/*   reserve: grow words until capacity bits fit
+ *   thiz: cbitvector pointer
+ *   capacity:   max bit count
+ */
+static    void    cbitvector_static_reserve(cbitvector *_thiz, uint64_t capacity) {
+	if (_thiz == NULL)
+		return;
+	cbitvector_words_grow((cbitvector_data*) _thiz, capacity);
+}
+
+/*   resize: set bit count, new bits equal bit
+ *   thiz: cbitvector pointer
+ *   n:    bit count
+ *   bit:  0 or 1
+ */
+static    void    cbitvector_static_resize(cbitvector *_thiz, uint64_t n, uint8_t bit) {
+	uint64_t old, first, words;
+	cbitvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return;
+	thiz = (cbitvector_data*) _thiz;
+	if (cbitvector_words_grow(thiz, n) != 0)
+		return;
+	old   = thiz->size;
+	words = cbitvector_word_count(n);
+	thiz->rank_valid = 0;
+	if (n <= old) {
+		// drop whole words behind n, then the bits behind n in the last word
+		memset(thiz->words + words, 0, (cbitvector_word_count(old) - words) * sizeof(uint64_t));
+		thiz->size = n;
+		cbitvector_tail_trim(thiz);
+		return;
+	}
+	thiz->size = n;
+	if (bit == 0)
+		return;
+	// bits behind old are already 0, fill the rest of its word then whole words
+	first = cbitvector_word_count(old);
+	if (old % 64 != 0)
+		thiz->words[old / 64] |= ~((1ULL << (old % 64)) - 1);
+	memset(thiz->words + first, 0xff, (words - first) * sizeof(uint64_t));
+	cbitvector_tail_trim(thiz);
+}
+
+/*   at: index bit
+ *   thiz: cbitvector pointer
+ *   index: bit index
+ *   return 0 or 1, 0 if index >= size
+ */
+static    uint8_t    cbitvector_static_at(cbitvector *_thiz, uint64_t index) {
+	cbitvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return 0;
+	thiz = (cbitvector_data*) _thiz;
+	if (index >= thiz->size)
+		return 0;
+	return (thiz->words[index / 64] >> (index % 64)) & 1;
+}
+
+/*   set: index bit = 1
+ *   thiz: cbitvector pointer
+ *   index: bit index
+ */
+static    void    cbitvector_static_set(cbitvector *_thiz, uint64_t index) {
+	cbitvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return;
+	thiz = (cbitvector_data*) _thiz;
+	if (index >= thiz->size)
+		return;
+	thiz->words[index / 64] |= 1ULL << (index % 64);
+	thiz->rank_valid = 0;
+}
+
+/*   reset: index bit = 0
+ *   thiz: cbitvector pointer
+ *   index: bit index
+ */
+static    void    cbitvector_static_reset(cbitvector *_thiz, uint64_t index) {
+	cbitvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return;
+	thiz = (cbitvector_data*) _thiz;
+	if (index >= thiz->size)
+		return;
+	thiz->words[index / 64] &= ~(1ULL << (index % 64));
+	thiz->rank_valid = 0;
+}
+
+/*   flip: index bit = !index bit
+ *   thiz: cbitvector pointer
+ *   index: bit index
+ */
+static    void    cbitvector_static_flip(cbitvector *_thiz, uint64_t index) {
+	cbitvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return;
+	thiz = (cbitvector_data*) _thiz;
+	if (index >= thiz->size)
+		return;
+	thiz->words[index / 64] ^= 1ULL << (index % 64);
+	thiz->rank_valid = 0;
+}
+
+/*   push_back: add last bit
+ *   thiz: cbitvector pointer
+ *   bit:  0 or 1
+ */
+static    void    cbitvector_static_push_back(cbitvector *_thiz, uint8_t bit) {
+	cbitvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return;
+	thiz = (cbitvector_data*) _thiz;
+	// double the words when full
+	if ((thiz->size == thiz->capacity * 64) && (cbitvector_words_grow(thiz, thiz->size * 2 + 64) != 0))
+		return;
+	if (bit)
+		thiz->words[thiz->size / 64] |= 1ULL << (thiz->size % 64);
+	thiz->size = thiz->size + 1;
+	thiz->rank_valid = 0;
+}
+
+/*   pop_back: delete last bit
+ *   thiz: cbitvector pointer
+ */
+static    void    cbitvector_static_pop_back(cbitvector *_thiz) {
+	cbitvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return;
+	thiz = (cbitvector_data*) _thiz;
+	if (thiz->size == 0)
+		return;
+	thiz->size = thiz->size - 1;
+	thiz->words[thiz->size / 64] &= ~(1ULL << (thiz->size % 64));
+	thiz->rank_valid = 0;
+}
+
+/*   data: first word pointer
+ *   thiz: cbitvector pointer
+ *   return first word pointer, valid until the next push
+ */
+static    uint64_t*    cbitvector_static_data(cbitvector *_thiz) {
+	if (_thiz == NULL)
+		return NULL;
+	// callers may write words, rank and select rebuild
+	((cbitvector_data*) _thiz)->rank_valid = 0;
+	return ((cbitvector_data*) _thiz)->words;
+}
+
+/*   popcount: count 1 bits
+ *   thiz: cbitvector pointer
+ *   return 1 bit count
+ */
+static uint64_t    cbitvector_static_popcount(cbitvector *_thiz) {
+	cbitvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return 0;
+	thiz = (cbitvector_data*) _thiz;
+	return cbitvector_kernel_get()->popcount(thiz->words, cbitvector_word_count(thiz->size));
+}
+
+/*   find_first_set: first 1 bit from index
+ *   thiz: cbitvector pointer
+ *   index: first bit index to look at
+ *   return bit index, UINT64_MAX if not found
+ */
+static uint64_t    cbitvector_static_find_first_set(cbitvector *_thiz, uint64_t index) {
+	uint64_t w, words, word;
+	cbitvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return UINT64_MAX;
+	thiz = (cbitvector_data*) _thiz;
+	if (index >= thiz->size)
+		return UINT64_MAX;
+	words = cbitvector_word_count(thiz->size);
+	w     = index / 64;
+	word  = thiz->words[w] & ~((1ULL << (index % 64)) - 1);
+	while (word == 0) {
+		if (++w >= words)
+			return UINT64_MAX;
+		word = thiz->words[w];
+	}
+	return w * 64 + __builtin_ctzll(word);
+}
+
+/*   bit_op: thiz = thiz op that on the first min size bits
+ *   thiz: cbitvector pointer
+ *   that: cbitvector pointer
+ *   op:   word kernel
+ */
+static    void    cbitvector_bit_op(cbitvector *_thiz, cbitvector *_that, void (*op)(uint64_t* dst, const uint64_t* src, uint64_t n)) {
+	uint64_t size;
+	cbitvector_data *thiz = NULL, *that = NULL;
+	if ((_thiz == NULL) || (_that == NULL))
+		return;
+	thiz = (cbitvector_data*) _thiz;
+	that = (cbitvector_data*) _that;
+	size = (thiz->size < that->size) ? thiz->size : that->size;
+	op(thiz->words, that->words, cbitvector_word_count(size));
+	// bits of that behind thiz size land in the last word of thiz
+	cbitvector_tail_trim(thiz);
+	thiz->rank_valid = 0;
+}
+
+/*   bit_and: thiz = thiz & that, bits of thiz behind that size become 0
+ *   thiz: cbitvector pointer
+ *   that: cbitvector pointer
+ */
+static    void    cbitvector_static_bit_and(cbitvector *_thiz, cbitvector *_that) {
+	uint64_t words, from;
+	cbitvector_data *thiz = NULL;
+	if ((_thiz == NULL) || (_that == NULL))
+		return;
+	thiz = (cbitvector_data*) _thiz;
+	cbitvector_bit_op(_thiz, _that, cbitvector_kernel_get()->bit_and);
+	// that is 0 behind its size
+	words = cbitvector_word_count(thiz->size);
+	from  = cbitvector_word_count(((cbitvector_data*) _that)->size);
+	if (from < words)
+		memset(thiz->words + from, 0, (words - from) * sizeof(uint64_t));
+}
+
+/*   bit_or: thiz = thiz | that, on the first min size bits
+ *   thiz: cbitvector pointer
+ *   that: cbitvector pointer
+ */
+static    void    cbitvector_static_bit_or(cbitvector *_thiz, cbitvector *_that) {
+	cbitvector_bit_op(_thiz, _that, cbitvector_kernel_get()->bit_or);
+}
+
+/*   bit_xor: thiz = thiz ^ that, on the first min size bits
+ *   thiz: cbitvector pointer
+ *   that: cbitvector pointer
+ */
+static    void    cbitvector_static_bit_xor(cbitvector *_thiz, cbitvector *_that) {
+	cbitvector_bit_op(_thiz, _that, cbitvector_kernel_get()->bit_xor);
+}
+
+/*   bit_andnot: thiz = thiz & ~that, on the first min size bits
+ *   thiz: cbitvector pointer
+ *   that: cbitvector pointer
+ */
+static    void    cbitvector_static_bit_andnot(cbitvector *_thiz, cbitvector *_that) {
+	cbitvector_bit_op(_thiz, _that, cbitvector_kernel_get()->bit_andnot);
+}
+
+/*   rank: count 1 bits before index
+ *   thiz: cbitvector pointer
+ *   index: bit index, index > size counts as size
+ *   return 1 bit count in [0, index)
+ */
+static uint64_t    cbitvector_static_rank(cbitvector *_thiz, uint64_t index) {
+	uint64_t w, b, count;
+	cbitvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return 0;
+	thiz = (cbitvector_data*) _thiz;
+	if (index > thiz->size)
+		index = thiz->size;
+	w = index / 64;
+	b = w / CBITVECTOR_BLOCK;
+	if (cbitvector_rank_build(thiz) != 0)
+		return cbitvector_kernel_get()->popcount(thiz->words, w)
+		     + ((index % 64) ? __builtin_popcountll(thiz->words[w] & ((1ULL << (index % 64)) - 1)) : 0);
+	count = thiz->ranks[b] + cbitvector_popcount_scalar(thiz->words + b * CBITVECTOR_BLOCK, w - b * CBITVECTOR_BLOCK);
+	if (index % 64)
+		count += __builtin_popcountll(thiz->words[w] & ((1ULL << (index % 64)) - 1));
+	return count;
+}
+
+/*   select: index of the k-th 1 bit, k from 0
+ *   thiz: cbitvector pointer
+ *   k:    1 bit rank
+ *   return bit index, UINT64_MAX if k >= popcount
+ */
+static uint64_t    cbitvector_static_select(cbitvector *_thiz, uint64_t k) {
+	uint64_t low, high, mid, w, words, word = 0, count;
+	cbitvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return UINT64_MAX;
+	thiz = (cbitvector_data*) _thiz;
+	words = cbitvector_word_count(thiz->size);
+	if (cbitvector_rank_build(thiz) != 0)
+		return UINT64_MAX;
+	// last block with fewer than k + 1 bits before it, the block after the words counts all
+	low  = 0;
+	high = words / CBITVECTOR_BLOCK;
+	if (thiz->ranks[high] + cbitvector_popcount_scalar(thiz->words + high * CBITVECTOR_BLOCK, words - high * CBITVECTOR_BLOCK) <= k)
+		return UINT64_MAX;
+	while (low < high) {
+		mid = low + (high - low + 1) / 2;
+		if (thiz->ranks[mid] <= k)
+			low = mid;
+		else
+			high = mid - 1;
+	}
+	count = thiz->ranks[low];
+	for (w = low * CBITVECTOR_BLOCK; w < words; ++w) {
+		word = thiz->words[w];
+		if (count + __builtin_popcountll(word) > k)
+			break;
+		count += __builtin_popcountll(word);
+	}
+	// drop the k - count lower 1 bits of the word
+	for (; count < k; ++count)
+		word &= word - 1;
+	return w * 64 + __builtin_ctzll(word);
+}
+
+/*   copy: copy thiz bits to that
+ *   thiz: cbitvector pointer
+ *   that: cbitvector pointer
+ */
+static    void    cbitvector_static_copy(cbitvector *_thiz, cbitvector *_that) {
+	uint64_t words;
+	cbitvector_data *thiz = NULL, *that = NULL;
+	if ((_thiz == NULL) || (_that == NULL) || (_thiz == _that))
+		return;
+	thiz = (cbitvector_data*) _thiz;
+	that = (cbitvector_data*) _that;
+	if (cbitvector_words_grow(that, thiz->size) != 0)
+		return;
+	words = cbitvector_word_count(thiz->size);
+	memcpy(that->words, thiz->words, words * sizeof(uint64_t));
+	if (that->size > thiz->size)
+		memset(that->words + words, 0, (cbitvector_word_count(that->size) - words) * sizeof(uint64_t));
+	that->size       = thiz->size;
+	that->rank_valid = 0;
+}
+
+/*   equal: bit count and bits equal
+ *   thiz: cbitvector pointer
+ *   that: cbitvector pointer
+ *   return 1 if equal
+ */
+static    uint8_t    cbitvector_static_equal(cbitvector *_thiz, cbitvector *_that) {
+	cbitvector_data *thiz = NULL, *that = NULL;
+	if ((_thiz == NULL) || (_that == NULL))
+		return 0;
+	thiz = (cbitvector_data*) _thiz;
+	that = (cbitvector_data*) _that;
+	if (thiz->size != that->size)
+		return 0;
+	// bits behind size are 0 in both
+	return (memcmp(thiz->words, that->words, cbitvector_word_count(thiz->size) * sizeof(uint64_t)) == 0) ? 1 : 0;
+}
+
+/*   cbitvector_alloc: malloc cbitvector pointer
+ *   size:     bit count capacity
+ *   return: cbitvector pointer
+ */
+cbitvector* cbitvector_alloc(uint64_t size) {
+	cbitvector *thiz = NULL;
+	cbitvector_data *thiz_data = NULL;
+	if (size <= 0)
+		return NULL;
+
+	thiz_data = (cbitvector_data *)malloc(sizeof(cbitvector_data));
+	if (thiz_data == NULL)
+		return NULL;
+	thiz_data->words      = NULL;
+	thiz_data->size       = 0;
+	thiz_data->capacity   = 0;
+	thiz_data->ranks      = NULL;
+	thiz_data->rank_count = 0;
+	thiz_data->rank_valid = 0;
+	if (cbitvector_words_grow(thiz_data, size) != 0) {
+		free(thiz_data);
+		return NULL;
+	}
+
+	thiz = (cbitvector*) &(thiz_data->vector);
+	thiz->clear  = cbitvector_static_clear;
+	thiz->free  = cbitvector_static_free;
+	thiz->size  = cbitvector_static_size;
+	thiz->capacity  = cbitvector_static_capacity;
+	thiz->empty  = cbitvector_static_empty;
+	thiz->reserve  = cbitvector_static_reserve;
+	thiz->resize  = cbitvector_static_resize;
+	thiz->at  = cbitvector_static_at;
+	thiz->set  = cbitvector_static_set;
+	thiz->reset  = cbitvector_static_reset;
+	thiz->flip  = cbitvector_static_flip;
+	thiz->push_back  = cbitvector_static_push_back;
+	thiz->pop_back  = cbitvector_static_pop_back;
+	thiz->data  = cbitvector_static_data;
+	thiz->popcount  = cbitvector_static_popcount;
+	thiz->find_first_set  = cbitvector_static_find_first_set;
+	thiz->bit_and  = cbitvector_static_bit_and;
+	thiz->bit_or  = cbitvector_static_bit_or;
+	thiz->bit_xor  = cbitvector_static_bit_xor;
+	thiz->bit_andnot  = cbitvector_static_bit_andnot;
+	thiz->rank  = cbitvector_static_rank;
+	thiz->select  = cbitvector_static_select;
+	thiz->copy  = cbitvector_static_copy;
+	thiz->equal  = cbitvector_static_equal;
+	return thiz;
+}
\ No newline at end of file
@@ -0,0 +1,183 @@
+#ifndef CBITVECTOR_H_INCLUDED
+#define CBITVECTOR_H_INCLUDED
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+struct cbitvector_t;
+typedef struct cbitvector_t cbitvector;
+
+// packed bit vector, bit i is bit i % 64 of word i / 64
+// word 0                       word 1
+// +-----------------------------+-----------------------------+
+// | bit 0  bit 1  ...  bit 63   | bit 64 ...   size - 1 | 0 0 |
+// +-----------------------------+-----------------------------+
+// bits behind size are always 0, bulk functions work a word at a time
+// rank and select keep a count per 512 bits, rebuilt on first use after a change
+struct cbitvector_t {
+/*   clear: clear data, but not free
+ *   thiz: cbitvector pointer
+ */
+    void      (*clear)(cbitvector *thiz);
+
+/*   free: free thiz and words
+ *   thiz: cbitvector pointer
+ */
+    void      (*free)(cbitvector *thiz);
+
+/*   size: get bit count
+ *   thiz: cbitvector pointer
+ *   return  bit count
+ */
+    uint64_t  (*size)(cbitvector *thiz);
+
+/*   capacity: get bit count the words hold
+ *   thiz: cbitvector pointer
+ *   return  max bit count
+ */
+    uint64_t  (*capacity)(cbitvector *thiz);
+
+/*   empty: bit count == 0
+ *   thiz: cbitvector pointer
+ *   return  bit count == 0
+ */
+    uint8_t   (*empty)(cbitvector *thiz);
+
+/*   reserve: grow words until capacity bits fit
+ *   thiz: cbitvector pointer
+ *   capacity:   max bit count
+ */
+    void      (*reserve)(cbitvector *thiz, uint64_t capacity);
+
+/*   resize: set bit count, new bits equal bit
+ *   thiz: cbitvector pointer
+ *   n:    bit count
+ *   bit:  0 or 1
+ */
+    void      (*resize)(cbitvector *thiz, uint64_t n, uint8_t bit);
+
+/*   at: index bit
+ *   thiz: cbitvector pointer
+ *   index: bit index
+ *   return 0 or 1, 0 if index >= size
+ */
+    uint8_t   (*at)(cbitvector *thiz, uint64_t index);
+
+/*   set: index bit = 1
+ *   thiz: cbitvector pointer
+ *   index: bit index
+ */
+    void      (*set)(cbitvector *thiz, uint64_t index);
+
+/*   reset: index bit = 0
+ *   thiz: cbitvector pointer
+ *   index: bit index
+ */
+    void      (*reset)(cbitvector *thiz, uint64_t index);
+
+/*   flip: index bit = !index bit
+ *   thiz: cbitvector pointer
+ *   index: bit index
+ */
+    void      (*flip)(cbitvector *thiz, uint64_t index);
+
+/*   push_back: add last bit
+ *   thiz: cbitvector pointer
+ *   bit:  0 or 1
+ */
+    void      (*push_back)(cbitvector *thiz, uint8_t bit);
+
+/*   pop_back: delete last bit
+ *   thiz: cbitvector pointer
+ */
+    void      (*pop_back)(cbitvector *thiz);
+
+/*   data: first word pointer, (size + 63) / 64 words
+ *   thiz: cbitvector pointer
+ *   return first word pointer, valid until the next push
+ */
+    uint64_t* (*data)(cbitvector *thiz);
+
+/*   popcount: count 1 bits
+ *   thiz: cbitvector pointer
+ *   return 1 bit count
+ */
+    uint64_t  (*popcount)(cbitvector *thiz);
+
+/*   find_first_set: first 1 bit from index
+ *   thiz: cbitvector pointer
+ *   index: first bit index to look at
+ *   return bit index, UINT64_MAX if not found
+ */
+    uint64_t  (*find_first_set)(cbitvector *thiz, uint64_t index);
+
+/*   bit_and: thiz = thiz & that, bits of thiz behind that size become 0
+ *   thiz: cbitvector pointer
+ *   that: cbitvector pointer
+ */
+    void      (*bit_and)(cbitvector *thiz, cbitvector *that);
+
+/*   bit_or: thiz = thiz | that, on the first min size bits
+ *   thiz: cbitvector pointer
+ *   that: cbitvector pointer
+ */
+    void      (*bit_or)(cbitvector *thiz, cbitvector *that);
+
+/*   bit_xor: thiz = thiz ^ that, on the first min size bits
+ *   thiz: cbitvector pointer
+ *   that: cbitvector pointer
+ */
+    void      (*bit_xor)(cbitvector *thiz, cbitvector *that);
+
+/*   bit_andnot: thiz = thiz & ~that, on the first min size bits
+ *   thiz: cbitvector pointer
+ *   that: cbitvector pointer
+ */
+    void      (*bit_andnot)(cbitvector *thiz, cbitvector *that);
+
+/*   rank: count 1 bits before index
+ *   thiz: cbitvector pointer
+ *   index: bit index, index > size counts as size
+ *   return 1 bit count in [0, index)
+ */
+    uint64_t  (*rank)(cbitvector *thiz, uint64_t index);
+
+/*   select: index of the k-th 1 bit, k from 0
+ *   thiz: cbitvector pointer
+ *   k:    1 bit rank
+ *   return bit index, UINT64_MAX if k >= popcount
+ */
+    uint64_t  (*select)(cbitvector *thiz, uint64_t k);
+
+/*   copy: copy thiz bits to that
+ *   thiz: cbitvector pointer
+ *   that: cbitvector pointer
+ */
+    void      (*copy)(cbitvector *thiz, cbitvector *that);
+
+/*   equal: bit count and bits equal
+ *   thiz: cbitvector pointer
+ *   that: cbitvector pointer
+ *   return 1 if equal
+ */
+    uint8_t   (*equal)(cbitvector *thiz, cbitvector *that);
+};
+
+/*   cbitvector_alloc: malloc cbitvector pointer
+ *   size:     bit count capacity
+ *   return: cbitvector pointer
+ */
+cbitvector* cbitvector_alloc(uint64_t size);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
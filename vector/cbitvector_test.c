@@ -0,0 +1,103 @@
+#include  <stddef.h>
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdlib.h>
+#include  <string.h>
+
+#include  "cbitvector.h"
+
+static void test_print(cbitvector *vec) {
+    uint64_t i;
+    printf("%lld %lld %d\n", vec->size(vec), vec->popcount(vec), vec->empty(vec));
+    for (i = 0; i < vec->size(vec); ++i) {
+    	printf("%d", vec->at(vec, i));
+    }
+    printf("\n");
+}
+
+static void test_bitvector1();
+
+static void test_bitvector2();
+
+static void test_bitvector3();
+
+int main(int argc, const char *argv[]) {
+	test_bitvector1();
+	test_bitvector2();
+	test_bitvector3();
+	return 0;
+}
+
+void test_bitvector1() {
+    printf("test push_back, set, resize\n");
+    int i;
+    cbitvector *vec = cbitvector_alloc(1);
+    for (i = 0; i < 70; ++i) {
+        vec->push_back(vec, (i % 3) == 0);
+    }
+    test_print(vec);
+    vec->set(vec, 1);
+    vec->reset(vec, 0);
+    vec->flip(vec, 69);
+    vec->pop_back(vec);
+    test_print(vec);
+    vec->resize(vec, 130, 1);
+    test_print(vec);
+    vec->resize(vec, 10, 0);
+    test_print(vec);
+    printf("%lld %lld %lld\n", vec->find_first_set(vec, 0), vec->find_first_set(vec, 4), vec->find_first_set(vec, 10));
+    vec->clear(vec);
+    test_print(vec);
+    vec->free(vec);
+}
+
+void test_bitvector2() {
+    printf("test and, or, xor, andnot\n");
+    int i;
+    cbitvector *vec1 = cbitvector_alloc(8);
+    cbitvector *vec2 = cbitvector_alloc(8);
+    for (i = 0; i < 20; ++i) {
+        vec1->push_back(vec1, (i % 2) == 0);
+        vec2->push_back(vec2, (i % 4) < 2);
+    }
+    vec2->pop_back(vec2);
+    vec2->pop_back(vec2);
+    vec2->bit_or(vec2, vec1);
+    test_print(vec2);
+    vec1->copy(vec1, vec2);
+    printf("%d\n", vec1->equal(vec1, vec2));
+    for (i = 0; i < 18; ++i) {
+        vec2->push_back(vec2, (i % 4) < 2);
+    }
+    vec2->bit_xor(vec2, vec1);
+    test_print(vec2);
+    vec1->bit_andnot(vec1, vec2);
+    test_print(vec1);
+    vec2->resize(vec2, 10, 0);
+    vec1->bit_and(vec1, vec2);
+    test_print(vec1);
+    vec1->free(vec1);
+    vec2->free(vec2);
+}
+
+void test_bitvector3() {
+    printf("test rank, select\n");
+    uint64_t i, k, ok = 1;
+    cbitvector *vec = cbitvector_alloc(64);
+    for (i = 0; i < 100000; ++i) {
+        vec->push_back(vec, (i % 7) == 0 || (i % 11) == 0);
+    }
+    for (i = 0, k = 0; i < vec->size(vec); ++i) {
+        if (vec->rank(vec, i) != k)
+            ok = 0;
+        if (vec->at(vec, i)) {
+            if (vec->select(vec, k) != i)
+                ok = 0;
+            ++k;
+        }
+    }
+    printf("%lld %lld %lld %d\n", vec->popcount(vec), vec->rank(vec, vec->size(vec)), ok, vec->select(vec, k) == UINT64_MAX);
+    vec->reset(vec, 0);
+    printf("%lld %lld\n", vec->rank(vec, 8), vec->select(vec, 0));
+    vec->free(vec);
+}
\ No newline at end of file
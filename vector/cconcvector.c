@@ -0,0 +1,385 @@
+#include <string.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include "cconcvector.h"
+
+// directory entries, segment k holds 1 << (shift + k) items then as many ready flags
+#define CCONCVECTOR_SEGMENT_MAX  64
+
+// slot flags, a slot is resolved once it is ready or dead
+#define CCONCVECTOR_SLOT_READY   1
+#define CCONCVECTOR_SLOT_DEAD    2
+
+// directory entry of a segment that failed to allocate for taken slots, all its slots are dead
+static    uint8_t    cconcvector_dead_segment;
+#define CCONCVECTOR_DEAD         (&cconcvector_dead_segment)
+
+struct cconcvector_data_t {
+	cconcvector                vector;
+    _Atomic(uint8_t*)          segments[CCONCVECTOR_SEGMENT_MAX];
+    uint64_t                   shift;
+    uint64_t                   typesize;
+    // writers and readers bump different counters, keep them on different cache lines
+    uint8_t                    pad0[64];
+    _Atomic uint64_t           reserved;
+    uint8_t                    pad1[64];
+    _Atomic uint64_t           published;
+    uint8_t                    pad2[64];
+};
+
+typedef struct cconcvector_data_t  cconcvector_data;
+
+
+/*   segment_get: segment k, malloc it if no thread did yet
+ *   thiz: cconcvector data pointer
+ *   k:    segment index
+ *   taken: 1 if the caller holds slots in k, on failure k becomes dead so size() goes past them
+ *   return segment pointer, NULL if out of memory or dead
+ */
+static    uint8_t*    cconcvector_segment_get(cconcvector_data *thiz, uint64_t k, uint8_t taken) {
+	uint64_t items;
+	uint8_t *ptr = NULL, *expected = NULL;
+	ptr = atomic_load_explicit(&thiz->segments[k], memory_order_acquire);
+	if (ptr == CCONCVECTOR_DEAD)
+		return NULL;
+	if (ptr != NULL)
+		return ptr;
+	items = 1ULL << (thiz->shift + k);
+	if (thiz->shift + k < CCONCVECTOR_SEGMENT_MAX - 1)
+		ptr = (uint8_t*) malloc(items * thiz->typesize + items);
+	if (ptr == NULL) {
+		if (!taken)
+			return NULL;
+		// another thread may have installed it meanwhile, then its slots live
+		if (atomic_compare_exchange_strong_explicit(&thiz->segments[k], &expected, CCONCVECTOR_DEAD,
+		                                            memory_order_acq_rel, memory_order_acquire))
+			return NULL;
+		return (expected == CCONCVECTOR_DEAD) ? NULL : expected;
+	}
+	memset(ptr + items * thiz->typesize, 0, items);
+	// first thread to install wins, the others free theirs
+	if (!atomic_compare_exchange_strong_explicit(&thiz->segments[k], &expected, ptr,
+	                                             memory_order_acq_rel, memory_order_acquire)) {
+		free(ptr);
+		return (expected == CCONCVECTOR_DEAD) ? NULL : expected;
+	}
+	return ptr;
+}
+
+/*   segment_index: segment and offset of index
+ *   thiz:   cconcvector data pointer
+ *   index:  item index
+ *   offset: set item offset in the segment
+ *   return segment index
+ */
+static inline uint64_t    cconcvector_segment_index(cconcvector_data *thiz, uint64_t index, uint64_t *offset) {
+	uint64_t pos = index + (1ULL << thiz->shift);
+	uint64_t msb = 63 - __builtin_clzll(pos);
+	*offset = pos - (1ULL << msb);
+	return msb - thiz->shift;
+}
+
+/*   segment_flags: ready flags of segment k
+ *   thiz: cconcvector data pointer
+ *   seg:  segment pointer
+ *   k:    segment index
+ *   return first flag pointer
+ */
+static inline _Atomic uint8_t*    cconcvector_segment_flags(cconcvector_data *thiz, uint8_t *seg, uint64_t k) {
+	return (_Atomic uint8_t*) (seg + (1ULL << (thiz->shift + k)) * thiz->typesize);
+}
+
+/*   write: copy n items from src to slots first.., then mark them ready
+ *   all segments are got first, if one fails every slot is marked dead, none is published
+ *   thiz:  cconcvector data pointer
+ *   first: first slot index
+ *   src:   first item pointer
+ *   n:     item count
+ *   return 0 if success, -1 if out of memory
+ */
+static    int    cconcvector_write(cconcvector_data *thiz, uint64_t first, const void* src, uint64_t n) {
+	uint64_t k, offset, room, chunk, i, index, count;
+	uint8_t *seg, flag = CCONCVECTOR_SLOT_READY;
+	_Atomic uint8_t *flags;
+	for (index = first, count = n; count > 0; index += chunk, count -= chunk) {
+		k     = cconcvector_segment_index(thiz, index, &offset);
+		room  = (1ULL << (thiz->shift + k)) - offset;
+		chunk = (count < room) ? count : room;
+		if (cconcvector_segment_get(thiz, k, 1) == NULL)
+			flag = CCONCVECTOR_SLOT_DEAD;
+	}
+	for (index = first, count = n; count > 0; index += chunk, count -= chunk) {
+		k     = cconcvector_segment_index(thiz, index, &offset);
+		room  = (1ULL << (thiz->shift + k)) - offset;
+		chunk = (count < room) ? count : room;
+		seg   = atomic_load_explicit(&thiz->segments[k], memory_order_acquire);
+		if (seg == CCONCVECTOR_DEAD)
+			continue;
+		if (flag == CCONCVECTOR_SLOT_READY)
+			memcpy(seg + offset * thiz->typesize, (const uint8_t*) src + (index - first) * thiz->typesize, chunk * thiz->typesize);
+		// items visible before their flags
+		flags = cconcvector_segment_flags(thiz, seg, k);
+		for (i = 0; i < chunk; ++i)
+			atomic_store_explicit(&flags[offset + i], flag, memory_order_release);
+	}
+	return (flag == CCONCVECTOR_SLOT_READY) ? 0 : -1;
+}
+
+
+/*   clear: clear data, but not free, not thread safe
+ *   thiz: cconcvector pointer
+ */
+static    void    cconcvector_static_clear(cconcvector *_thiz) {
+	uint64_t k;
+	uint8_t *seg;
+	cconcvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return;
+	thiz = (cconcvector_data*) _thiz;
+	for (k = 0; k < CCONCVECTOR_SEGMENT_MAX; ++k) {
+		seg = atomic_load_explicit(&thiz->segments[k], memory_order_relaxed);
+		// a dead segment may allocate again
+		if (seg == CCONCVECTOR_DEAD)
+			atomic_store_explicit(&thiz->segments[k], NULL, memory_order_relaxed);
+		else if (seg != NULL)
+			memset((uint8_t*) cconcvector_segment_flags(thiz, seg, k), 0, 1ULL << (thiz->shift + k));
+	}
+	atomic_store_explicit(&thiz->reserved,  0, memory_order_relaxed);
+	atomic_store_explicit(&thiz->published, 0, memory_order_release);
+}
+
+/*   free: free thiz and segments, not thread safe
+ *   thiz: cconcvector pointer
+ */
+static    void    cconcvector_static_free(cconcvector *_thiz) {
+	uint64_t k;
+	uint8_t *seg;
+	cconcvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return;
+	thiz = (cconcvector_data*) _thiz;
+	for (k = 0; k < CCONCVECTOR_SEGMENT_MAX; ++k) {
+		seg = atomic_load_explicit(&thiz->segments[k], memory_order_relaxed);
+		if (seg != CCONCVECTOR_DEAD)
+			free(seg);
+	}
+	free(thiz);
+}
+
+/*   typesize: get item size
+ *   thiz: cconcvector pointer
+ *   return  item size > 0
+ */
+static uint64_t    cconcvector_static_typesize(cconcvector *_thiz) {
+	if (_thiz == NULL)
+		return 0;
+	return ((cconcvector_data*) _thiz)->typesize;
+}
+
+/*   size: publish and get the resolved prefix item count, ready or dead slots
+ *   thiz: cconcvector pointer
+ *   return  item count, every item below it is readable or dead
+ */
+static uint64_t    cconcvector_static_size(cconcvector *_thiz) {
+	uint64_t start, ready, reserved, k, offset, items;
+	uint8_t *seg;
+	_Atomic uint8_t *flags;
+	cconcvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return 0;
+	thiz = (cconcvector_data*) _thiz;
+	start    = atomic_load_explicit(&thiz->published, memory_order_acquire);
+	reserved = atomic_load_explicit(&thiz->reserved, memory_order_relaxed);
+
+	// walk ready flags from the published size, a segment at a time
+	ready = start;
+	while (ready < reserved) {
+		k   = cconcvector_segment_index(thiz, ready, &offset);
+		seg = atomic_load_explicit(&thiz->segments[k], memory_order_acquire);
+		if (seg == NULL)
+			break;
+		items = 1ULL << (thiz->shift + k);
+		// every taken slot of a dead segment is dead
+		if (seg == CCONCVECTOR_DEAD) {
+			ready = ready + items - offset;
+			if (ready > reserved)
+				ready = reserved;
+			continue;
+		}
+		flags = cconcvector_segment_flags(thiz, seg, k);
+		while ((offset < items) && (ready < reserved) &&
+		       atomic_load_explicit(&flags[offset], memory_order_acquire)) {
+			++offset;
+			++ready;
+		}
+		if (offset < items)
+			break;
+	}
+	if (ready == start)
+		return start;
+
+	// only move forward, another reader may have gone further
+	while (start < ready) {
+		if (atomic_compare_exchange_weak_explicit(&thiz->published, &start, ready,
+		                                          memory_order_release, memory_order_acquire))
+			return ready;
+	}
+	return start;
+}
+
+/*   reserved: get item count handed out to writers
+ *   thiz: cconcvector pointer
+ *   return  item count >= size
+ */
+static uint64_t    cconcvector_static_reserved(cconcvector *_thiz) {
+	if (_thiz == NULL)
+		return 0;
+	return atomic_load_explicit(&((cconcvector_data*) _thiz)->reserved, memory_order_relaxed);
+}
+
+/*   reserve: allocate segments until capacity items fit
+ *   thiz: cconcvector pointer
+ *   capacity:   max item count
+ */
+static    void    cconcvector_static_reserve(cconcvector *_thiz, uint64_t capacity) {
+	uint64_t k, offset;
+	cconcvector_data *thiz = NULL;
+	if ((_thiz == NULL) || (capacity <= 0))
+		return;
+	thiz = (cconcvector_data*) _thiz;
+	for (k = 0; k <= cconcvector_segment_index(thiz, capacity - 1, &offset); ++k) {
+		if (cconcvector_segment_get(thiz, k, 0) == NULL)
+			return;
+	}
+}
+
+/*   at: index item pointer
+ *   thiz: cconcvector pointer
+ *   index: item index
+ *   return index item pointer, NULL if index >= last published size or the slot is dead
+ */
+static    void*    cconcvector_static_at(cconcvector *_thiz, uint64_t index) {
+	uint64_t k, offset;
+	uint8_t *seg;
+	cconcvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return NULL;
+	thiz = (cconcvector_data*) _thiz;
+	if (index >= atomic_load_explicit(&thiz->published, memory_order_acquire))
+		return NULL;
+	k   = cconcvector_segment_index(thiz, index, &offset);
+	seg = atomic_load_explicit(&thiz->segments[k], memory_order_relaxed);
+	if ((seg == CCONCVECTOR_DEAD) ||
+	    (atomic_load_explicit(&cconcvector_segment_flags(thiz, seg, k)[offset], memory_order_relaxed) == CCONCVECTOR_SLOT_DEAD))
+		return NULL;
+	return seg + offset * thiz->typesize;
+}
+
+/*   push_back_n: add n items with consecutive indexes, copied from src
+ *   thiz: cconcvector pointer
+ *   src:  first item pointer, contiguous
+ *   n:    item count
+ *   return first item index, UINT64_MAX if out of memory
+ */
+static    uint64_t    cconcvector_static_push_back_n(cconcvector *_thiz, const void* src, uint64_t n) {
+	uint64_t first;
+	cconcvector_data *thiz = NULL;
+	if ((_thiz == NULL) || (src == NULL) || (n <= 0))
+		return UINT64_MAX;
+	thiz = (cconcvector_data*) _thiz;
+	first = atomic_fetch_add_explicit(&thiz->reserved, n, memory_order_relaxed);
+	// slots stay taken on failure as dead slots, size() goes past them
+	if (cconcvector_write(thiz, first, src, n) != 0)
+		return UINT64_MAX;
+	return first;
+}
+
+/*   push_back: add last item
+ *   thiz: cconcvector pointer
+ *   val:  item pointer
+ *   return item index, UINT64_MAX if out of memory
+ */
+static    uint64_t    cconcvector_static_push_back(cconcvector *_thiz, const void* val) {
+	return cconcvector_static_push_back_n(_thiz, val, 1);
+}
+
+/*   emplace_back: take one slot, write it, then commit its index
+ *   thiz:  cconcvector pointer
+ *   index: set item index
+ *   return item pointer, NULL if out of memory
+ */
+static    void*    cconcvector_static_emplace_back(cconcvector *_thiz, uint64_t *index) {
+	uint64_t k, offset;
+	uint8_t *seg;
+	cconcvector_data *thiz = NULL;
+	if ((_thiz == NULL) || (index == NULL))
+		return NULL;
+	thiz = (cconcvector_data*) _thiz;
+	*index = atomic_fetch_add_explicit(&thiz->reserved, 1, memory_order_relaxed);
+	k   = cconcvector_segment_index(thiz, *index, &offset);
+	// on failure the segment is dead, so is the slot
+	seg = cconcvector_segment_get(thiz, k, 1);
+	if (seg == NULL)
+		return NULL;
+	return seg + offset * thiz->typesize;
+}
+
+/*   commit: mark an emplace_back slot ready
+ *   thiz:  cconcvector pointer
+ *   index: item index from emplace_back
+ */
+static    void    cconcvector_static_commit(cconcvector *_thiz, uint64_t index) {
+	uint64_t k, offset;
+	uint8_t *seg;
+	cconcvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return;
+	thiz = (cconcvector_data*) _thiz;
+	if (index >= atomic_load_explicit(&thiz->reserved, memory_order_relaxed))
+		return;
+	k   = cconcvector_segment_index(thiz, index, &offset);
+	seg = atomic_load_explicit(&thiz->segments[k], memory_order_acquire);
+	if ((seg != NULL) && (seg != CCONCVECTOR_DEAD))
+		atomic_store_explicit(&cconcvector_segment_flags(thiz, seg, k)[offset], CCONCVECTOR_SLOT_READY, memory_order_release);
+}
+
+/*   cconcvector_alloc: malloc cconcvector pointer
+ *   size:     first segment item count, rounded up to a power of two
+ *   typesize: item size
+ *   return: cconcvector pointer
+ */
+cconcvector* cconcvector_alloc(uint64_t size, uint64_t typesize) {
+	uint64_t k;
+	cconcvector *thiz = NULL;
+	cconcvector_data *thiz_data = NULL;
+	if ((size <= 0) || (typesize <= 0) || (size > (1ULL << 32)))
+		return NULL;
+
+	thiz_data = (cconcvector_data *)malloc(sizeof(cconcvector_data));
+	if (thiz_data == NULL)
+		return NULL;
+	for (k = 0; k < CCONCVECTOR_SEGMENT_MAX; ++k)
+		atomic_init(&thiz_data->segments[k], NULL);
+	atomic_init(&thiz_data->reserved, 0);
+	atomic_init(&thiz_data->published, 0);
+	thiz_data->typesize = typesize;
+	thiz_data->shift    = (size > 1) ? (64 - __builtin_clzll(size - 1)) : 0;
+	if (cconcvector_segment_get(thiz_data, 0, 0) == NULL) {
+		free(thiz_data);
+		return NULL;
+	}
+
+	thiz = (cconcvector*) &(thiz_data->vector);
+	thiz->clear  = cconcvector_static_clear;
+	thiz->free  = cconcvector_static_free;
+	thiz->typesize  = cconcvector_static_typesize;
+	thiz->size  = cconcvector_static_size;
+	thiz->reserved  = cconcvector_static_reserved;
+	thiz->reserve  = cconcvector_static_reserve;
+	thiz->at  = cconcvector_static_at;
+	thiz->push_back  = cconcvector_static_push_back;
+	thiz->push_back_n  = cconcvector_static_push_back_n;
+	thiz->emplace_back  = cconcvector_static_emplace_back;
+	thiz->commit  = cconcvector_static_commit;
+	return thiz;
+}
\ No newline at end of file
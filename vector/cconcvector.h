@@ -0,0 +1,113 @@
+#ifndef CCONCVECTOR_H_INCLUDED
+#define CCONCVECTOR_H_INCLUDED
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+struct cconcvector_t;
+typedef struct cconcvector_t cconcvector;
+
+// concurrent append vector, many threads push_back without a lock
+// a writer takes slots with an atomic fetch-add on reserved, writes them,
+// then marks each slot ready; segments as in csegvector never move
+// size() is the published prefix: every slot below it is written and visible, or dead
+// a push that runs out of memory leaves its slots dead, at() returns NULL for them
+// 0                      size()          reserved
+// |                        |               |
+// V                        V               V
+// +----------------------------------------+-----------+
+// | ready, readable by at()| being written  |  free     |
+// +----------------------------------------+-----------+
+// clear and free must not run with other calls
+struct cconcvector_t {
+/*   clear: clear data, but not free, not thread safe
+ *   thiz: cconcvector pointer
+ */
+    void      (*clear)(cconcvector *thiz);
+
+/*   free: free thiz and segments, not thread safe
+ *   thiz: cconcvector pointer
+ */
+    void      (*free)(cconcvector *thiz);
+
+/*   typesize: get item size
+ *   thiz: cconcvector pointer
+ *   return  item size > 0
+ */
+    uint64_t  (*typesize)(cconcvector *thiz);
+
+/*   size: publish and get the resolved prefix item count, dead slots included
+ *   thiz: cconcvector pointer
+ *   return  item count, every item below it is readable or dead
+ */
+    uint64_t  (*size)(cconcvector *thiz);
+
+/*   reserved: get item count handed out to writers
+ *   thiz: cconcvector pointer
+ *   return  item count >= size
+ */
+    uint64_t  (*reserved)(cconcvector *thiz);
+
+/*   reserve: allocate segments until capacity items fit
+ *   thiz: cconcvector pointer
+ *   capacity:   max item count
+ */
+    void      (*reserve)(cconcvector *thiz, uint64_t capacity);
+
+/*   at: index item pointer
+ *   thiz: cconcvector pointer
+ *   index: item index
+ *   return index item pointer, NULL if index >= last published size or the slot is dead
+ */
+    void*     (*at)(cconcvector *thiz, uint64_t index);
+
+/*   push_back: add last item
+ *   thiz: cconcvector pointer
+ *   val:  item pointer
+ *   return item index, UINT64_MAX if out of memory, the slot is dead then
+ */
+    uint64_t  (*push_back)(cconcvector *thiz, const void* val);
+
+/*   push_back_n: add n items with consecutive indexes, copied from src
+ *   thiz: cconcvector pointer
+ *   src:  first item pointer, contiguous
+ *   n:    item count
+ *   return first item index, UINT64_MAX if out of memory, all n slots are dead then
+ */
+    uint64_t  (*push_back_n)(cconcvector *thiz, const void* src, uint64_t n);
+
+/*   emplace_back: take one slot, write it, then commit its index
+ *   every slot taken must be committed, size() stops before an uncommitted one
+ *   and no later item is published until it is
+ *   thiz:  cconcvector pointer
+ *   index: set item index
+ *   return item pointer, NULL if out of memory, the slot is dead then, no commit needed
+ */
+    void*     (*emplace_back)(cconcvector *thiz, uint64_t *index);
+
+/*   commit: mark an emplace_back slot ready
+ *   thiz:  cconcvector pointer
+ *   index: item index from emplace_back
+ */
+    void      (*commit)(cconcvector *thiz, uint64_t index);
+};
+
+/*   cconcvector_alloc: malloc cconcvector pointer
+ *   size:     first segment item count, rounded up to a power of two
+ *   typesize: item size
+ *   return: cconcvector pointer
+ */
+cconcvector* cconcvector_alloc(uint64_t size, uint64_t typesize);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
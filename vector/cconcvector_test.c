@@ -0,0 +1,80 @@
+#include  <stddef.h>
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  <pthread.h>
+
+#include  "cconcvector.h"
+
+#define TEST_THREADS  (4)
+#define TEST_COUNT    (100000)
+
+static void test_concvector1();
+
+static void test_concvector2();
+
+int main(int argc, const char *argv[]) {
+	test_concvector1();
+	test_concvector2();
+	return 0;
+}
+
+void test_concvector1() {
+    printf("test push_back, emplace_back, commit\n");
+    int buf[] = {0x01, 0x12, 0x23, 0x34, 0x45};
+    uint64_t i, index;
+    int *item;
+    cconcvector *vec = cconcvector_alloc(2, sizeof(int));
+    for (i = 0; i < 3; ++i) {
+        printf("%llu ", (unsigned long long) vec->push_back(vec, &buf[i]));
+    }
+    printf("%llu\n", (unsigned long long) vec->push_back_n(vec, buf, 5));
+    // an uncommitted slot holds back the published size
+    item = vec->emplace_back(vec, &index);
+    vec->push_back(vec, &buf[4]);
+    printf("%llu %llu\n", (unsigned long long) vec->size(vec), (unsigned long long) vec->reserved(vec));
+    *item = 0x56;
+    vec->commit(vec, index);
+    printf("%llu %llu\n", (unsigned long long) vec->size(vec), (unsigned long long) vec->reserved(vec));
+    for (i = 0; i < vec->size(vec); ++i) {
+        printf("%x ", *((int*) vec->at(vec, i)));
+    }
+    printf("\n");
+    vec->clear(vec);
+    printf("%llu %d\n", (unsigned long long) vec->size(vec), vec->at(vec, 0) == NULL);
+    vec->free(vec);
+}
+
+static void* test_writer(void *arg) {
+    cconcvector *vec = (cconcvector*) arg;
+    uint64_t i;
+    for (i = 0; i < TEST_COUNT; ++i) {
+        vec->push_back(vec, &i);
+        // readers publish while writers append
+        if ((i & 1023) == 0)
+            vec->size(vec);
+    }
+    return NULL;
+}
+
+void test_concvector2() {
+    printf("test threads\n");
+    pthread_t threads[TEST_THREADS];
+    uint64_t i, sum = 0, want = 0;
+    cconcvector *vec = cconcvector_alloc(16, sizeof(uint64_t));
+    for (i = 0; i < TEST_THREADS; ++i) {
+        pthread_create(&threads[i], NULL, test_writer, vec);
+    }
+    for (i = 0; i < TEST_THREADS; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+    for (i = 0; i < vec->size(vec); ++i) {
+        sum += *((uint64_t*) vec->at(vec, i));
+    }
+    for (i = 0; i < TEST_COUNT; ++i) {
+        want += i;
+    }
+    printf("%llu %d\n", (unsigned long long) vec->size(vec), sum == want * TEST_THREADS);
+    vec->free(vec);
+}
\ No newline at end of file
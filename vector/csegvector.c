@@ -0,0 +1,489 @@
+#include <string.h>
+#include <stdlib.h>
+#include "csegvector.h"
+#include "cvector_algo.h"
+
+// directory entries, segment k holds 1 << (shift + k) items
+#define CSEGVECTOR_SEGMENT_MAX  64
+
+struct csegvector_data_t {
+	csegvector                 vector;
+    void*                      segments[CSEGVECTOR_SEGMENT_MAX];
+    void*                      last;
+    void*                      final;
+    uint64_t                   count;
+    uint64_t                   size;
+    uint64_t                   shift;
+    uint64_t                   typesize;
+};
+
+typedef struct csegvector_data_t  csegvector_data;
+
+
+/*   segment_locate: index item pointer, index < capacity
+ *   thiz: csegvector data pointer
+ *   index: item index
+ *   return item pointer
+ */
+static inline void*    csegvector_segment_locate(csegvector_data *thiz, uint64_t index) {
+	uint64_t pos = index + (1ULL << thiz->shift);
+	uint64_t msb = 63 - __builtin_clzll(pos);
+	return (uint8_t*) thiz->segments[msb - thiz->shift] + (pos - (1ULL << msb)) * thiz->typesize;
+}
+
+/*   segment_capacity: item count of the first count segments
+ *   thiz: csegvector data pointer
+ *   count: segment count
+ *   return item count
+ */
+static inline uint64_t    csegvector_segment_capacity(csegvector_data *thiz, uint64_t count) {
+	return ((1ULL << count) - 1) << thiz->shift;
+}
+
+/*   segment_tail: set last to item size slot and final to its segment end, both NULL when full
+ *   thiz: csegvector data pointer
+ */
+static    void    csegvector_segment_tail(csegvector_data *thiz) {
+	uint64_t pos, msb;
+	if (thiz->size >= csegvector_segment_capacity(thiz, thiz->count)) {
+		thiz->last  = NULL;
+		thiz->final = NULL;
+		return;
+	}
+	pos = thiz->size + (1ULL << thiz->shift);
+	msb = 63 - __builtin_clzll(pos);
+	thiz->last  = (uint8_t*) thiz->segments[msb - thiz->shift] + (pos - (1ULL << msb)) * thiz->typesize;
+	thiz->final = (uint8_t*) thiz->segments[msb - thiz->shift] + (1ULL << msb) * thiz->typesize;
+}
+
+/*   segment_add: malloc the next segment, existing segments stay
+ *   thiz: csegvector data pointer
+ *   return 0 if success, -1 if out of memory or directory full
+ */
+static    int    csegvector_segment_add(csegvector_data *thiz) {
+	void* ptr = NULL;
+	if (thiz->shift + thiz->count >= CSEGVECTOR_SEGMENT_MAX - 1)
+		return -1;
+	ptr = malloc((1ULL << (thiz->shift + thiz->count)) * thiz->typesize);
+	if (ptr == NULL)
+		return -1;
+	thiz->segments[thiz->count] = ptr;
+	thiz->count = thiz->count + 1;
+	csegvector_segment_tail(thiz);
+	return 0;
+}
+
+/*   segment_free: free every segment
+ *   thiz: csegvector data pointer
+ */
+static    void    csegvector_segment_free(csegvector_data *thiz) {
+	uint64_t k;
+	for (k = 0; k < thiz->count; ++k)
+		free(thiz->segments[k]);
+	thiz->count = 0;
+	thiz->size  = 0;
+	csegvector_segment_tail(thiz);
+}
+
+/*   segment_used: used item count of segment k
+ *   thiz: csegvector data pointer
+ *   k:    segment index
+ *   return item count
+ */
+static    uint64_t    csegvector_segment_used(csegvector_data *thiz, uint64_t k) {
+	uint64_t first = csegvector_segment_capacity(thiz, k), items = 1ULL << (thiz->shift + k);
+	if ((k >= thiz->count) || (thiz->size <= first))
+		return 0;
+	return (thiz->size - first < items) ? (thiz->size - first) : items;
+}
+
+
+/*   clear: clear data, but not free
+ *   thiz: csegvector pointer
+ */
+static    void    csegvector_static_clear(csegvector *_thiz) {
+	csegvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return;
+	thiz = (csegvector_data*) _thiz;
+	thiz->size = 0;
+	csegvector_segment_tail(thiz);
+}
+
+/*   free: free thiz and segments
+ *   thiz: csegvector pointer
+ */
+static    void    csegvector_static_free(csegvector *_thiz) {
+	csegvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return;
+	thiz = (csegvector_data*) _thiz;
+	csegvector_segment_free(thiz);
+	free(thiz);
+}
+
+/*   typesize: get item size
+ *   thiz: csegvector pointer
+ *   return  item size > 0
+ */
+static uint64_t    csegvector_static_typesize(csegvector *_thiz) {
+	if (_thiz == NULL)
+		return 0;
+	return ((csegvector_data*) _thiz)->typesize;
+}
+
+/*   size: get item count
+ *   thiz: csegvector pointer
+ *   return  item count
+ */
+static uint64_t    csegvector_static_size(csegvector *_thiz) {
+	if (_thiz == NULL)
+		return 0;
+	return ((csegvector_data*) _thiz)->size;
+}
+
+/*   capacity: get item count of the allocated segments
+ *   thiz: csegvector pointer
+ *   return  max item count before a new segment
+ */
+static uint64_t    csegvector_static_capacity(csegvector *_thiz) {
+	csegvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return 0;
+	thiz = (csegvector_data*) _thiz;
+	return csegvector_segment_capacity(thiz, thiz->count);
+}
+
+/*   empty: item count == 0
+ *   thiz: csegvector pointer
+ *   return  item count == 0
+ */
+static uint8_t    csegvector_static_empty(csegvector *_thiz) {
+	if (_thiz == NULL)
+		return 0;
+	return (((csegvector_data*) _thiz)->size == 0) ? 1 : 0;
+}
+
+/*   reserve: add segments until capacity items fit
+ *   thiz: csegvector pointer
+ *   capacity:   max item count
+ */
+static    void    csegvector_static_reserve(csegvector *_thiz, uint64_t capacity) {
+	csegvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return;
+	thiz = (csegvector_data*) _thiz;
+	while (csegvector_segment_capacity(thiz, thiz->count) < capacity) {
+		if (csegvector_segment_add(thiz) != 0)
+			return;
+	}
+}
+
+/*   resize: set n items equal val
+ *   thiz: csegvector pointer
+ *   n:    n items  equal val
+ *   val:  item pointer
+ */
+static    void    csegvector_static_resize(csegvector *_thiz, uint64_t n, const void* val) {
+	uint8_t buf[64];
+	void* tmp = NULL;
+	uint64_t i;
+	csegvector_data *thiz = NULL;
+	if ((_thiz == NULL) || (val == NULL))
+		return;
+	thiz = (csegvector_data*) _thiz;
+	// val may be one of the items being overwritten
+	tmp = (thiz->typesize <= sizeof(buf)) ? buf : malloc(thiz->typesize);
+	if (tmp == NULL)
+		return;
+	memcpy(tmp, val, thiz->typesize);
+	_thiz->reserve(_thiz, n);
+	if (csegvector_segment_capacity(thiz, thiz->count) >= n) {
+		for (i = 0; i < n; ++i)
+			memcpy(csegvector_segment_locate(thiz, i), tmp, thiz->typesize);
+		thiz->size = n;
+		csegvector_segment_tail(thiz);
+	}
+	if (tmp != buf)
+		free(tmp);
+}
+
+/*   back: last item pointer
+ *   thiz: csegvector pointer
+ *   return last item pointer, NULL if empty
+ */
+static    void*    csegvector_static_back(csegvector *_thiz) {
+	csegvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return NULL;
+	thiz = (csegvector_data*) _thiz;
+	if (thiz->size == 0)
+		return NULL;
+	return csegvector_segment_locate(thiz, thiz->size - 1);
+}
+
+/*   front: first item pointer
+ *   thiz: csegvector pointer
+ *   return first item pointer, NULL if empty
+ */
+static    void*    csegvector_static_front(csegvector *_thiz) {
+	csegvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return NULL;
+	thiz = (csegvector_data*) _thiz;
+	if (thiz->size == 0)
+		return NULL;
+	return thiz->segments[0];
+}
+
+/*   at: index item pointer
+ *   thiz: csegvector pointer
+ *   index: item index
+ *   return index item pointer, NULL if index >= size
+ */
+static    void*    csegvector_static_at(csegvector *_thiz, uint64_t index) {
+	csegvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return NULL;
+	thiz = (csegvector_data*) _thiz;
+	if (index >= thiz->size)
+		return NULL;
+	return csegvector_segment_locate(thiz, index);
+}
+
+/*   segment: items of one segment
+ *   thiz: csegvector pointer
+ *   index: segment index
+ *   count: set used item count of the segment
+ *   return first item pointer, NULL if the segment holds no item
+ */
+static    void*    csegvector_static_segment(csegvector *_thiz, uint64_t index, uint64_t *count) {
+	uint64_t used;
+	csegvector_data *thiz = NULL;
+	if ((_thiz == NULL) || (count == NULL))
+		return NULL;
+	thiz = (csegvector_data*) _thiz;
+	used = csegvector_segment_used(thiz, index);
+	*count = used;
+	if (used == 0)
+		return NULL;
+	return thiz->segments[index];
+}
+
+/*   emplace_back: add an uninitialized last item
+ *   thiz: csegvector pointer
+ *   return new item pointer, NULL if out of memory
+ */
+static    void*    csegvector_static_emplace_back(csegvector *_thiz) {
+	void* ptr = NULL;
+	csegvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return NULL;
+	thiz = (csegvector_data*) _thiz;
+	if (thiz->last == thiz->final) {
+		if (csegvector_segment_add(thiz) != 0)
+			return NULL;
+	}
+	ptr = thiz->last;
+	thiz->size = thiz->size + 1;
+	thiz->last = (uint8_t*) thiz->last + thiz->typesize;
+	// segment full, the next item starts the next segment
+	if (thiz->last == thiz->final)
+		csegvector_segment_tail(thiz);
+	return ptr;
+}
+
+/*   push_back: add last item
+ *   thiz: csegvector pointer
+ *   val:  item pointer
+ */
+static    void    csegvector_static_push_back(csegvector *_thiz, const void* val) {
+	void* ptr = NULL;
+	csegvector_data *thiz = NULL;
+	if ((_thiz == NULL) || (val == NULL))
+		return;
+	thiz = (csegvector_data*) _thiz;
+	// items never move, val stays valid across a new segment
+	if (thiz->last < thiz->final) {
+		memcpy(thiz->last, val, thiz->typesize);
+		thiz->size = thiz->size + 1;
+		thiz->last = (uint8_t*) thiz->last + thiz->typesize;
+		if (thiz->last < thiz->final)
+			return;
+		csegvector_segment_tail(thiz);
+		return;
+	}
+	ptr = csegvector_static_emplace_back(_thiz);
+	if (ptr != NULL)
+		memcpy(ptr, val, thiz->typesize);
+}
+
+/*   pop_back: delete last item, its segment is kept
+ *   thiz: csegvector pointer
+ */
+static    void    csegvector_static_pop_back(csegvector *_thiz) {
+	csegvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return;
+	thiz = (csegvector_data*) _thiz;
+	if (thiz->size == 0)
+		return;
+	thiz->size = thiz->size - 1;
+	csegvector_segment_tail(thiz);
+}
+
+/*   push_back_n: add n items behind, copied from src
+ *   thiz: csegvector pointer
+ *   src:  first item pointer, contiguous
+ *   n:    item count
+ */
+static    void    csegvector_static_push_back_n(csegvector *_thiz, const void* src, uint64_t n) {
+	uint64_t pos, msb, room, chunk;
+	csegvector_data *thiz = NULL;
+	if ((_thiz == NULL) || (src == NULL) || (n <= 0))
+		return;
+	thiz = (csegvector_data*) _thiz;
+	_thiz->reserve(_thiz, thiz->size + n);
+	if (csegvector_segment_capacity(thiz, thiz->count) < thiz->size + n)
+		return;
+	// one memcpy per segment touched
+	while (n > 0) {
+		pos   = thiz->size + (1ULL << thiz->shift);
+		msb   = 63 - __builtin_clzll(pos);
+		room  = (2ULL << msb) - pos;
+		chunk = (n < room) ? n : room;
+		memcpy(csegvector_segment_locate(thiz, thiz->size), src, chunk * thiz->typesize);
+		src        = (const uint8_t*) src + chunk * thiz->typesize;
+		thiz->size = thiz->size + chunk;
+		n          = n - chunk;
+	}
+	csegvector_segment_tail(thiz);
+}
+
+/*   find: first item equal val
+ *   thiz: csegvector pointer
+ *   val:  item pointer
+ *   return item pointer, NULL if not found
+ */
+static    void*    csegvector_static_find(csegvector *_thiz, const void* val) {
+	uint64_t k, used;
+	void* ptr = NULL;
+	csegvector_data *thiz = NULL;
+	if ((_thiz == NULL) || (val == NULL))
+		return NULL;
+	thiz = (csegvector_data*) _thiz;
+	for (k = 0; k < thiz->count; ++k) {
+		used = csegvector_segment_used(thiz, k);
+		if (used == 0)
+			break;
+		ptr = cvector_algo_find(thiz->segments[k], used, thiz->typesize, val);
+		if (ptr != NULL)
+			return ptr;
+	}
+	return NULL;
+}
+
+/*   copy: copy thiz items to that
+ *   thiz: csegvector pointer
+ *   that: csegvector pointer
+ */
+static    void    csegvector_static_copy(csegvector *_thiz, csegvector *_that) {
+	uint64_t k, used;
+	csegvector_data *thiz = NULL, *that = NULL;
+	if ((_thiz == NULL) || (_that == NULL) || (_thiz == _that))
+		return;
+	thiz = (csegvector_data*) _thiz;
+	that = (csegvector_data*) _that;
+	// segments of that are sized for its own typesize
+	if (that->typesize != thiz->typesize) {
+		csegvector_segment_free(that);
+		that->typesize = thiz->typesize;
+	}
+	that->size = 0;
+	csegvector_segment_tail(that);
+	for (k = 0; k < thiz->count; ++k) {
+		used = csegvector_segment_used(thiz, k);
+		if (used == 0)
+			break;
+		_that->push_back_n(_that, thiz->segments[k], used);
+	}
+}
+
+/*   equal: item count and items equal
+ *   thiz: csegvector pointer
+ *   that: csegvector pointer
+ *   return 1 if equal
+ */
+static    uint8_t    csegvector_static_equal(csegvector *_thiz, csegvector *_that) {
+	uint64_t i;
+	csegvector_data *thiz = NULL, *that = NULL;
+	if ((_thiz == NULL) || (_that == NULL))
+		return 0;
+	thiz = (csegvector_data*) _thiz;
+	that = (csegvector_data*) _that;
+	if ((thiz->typesize != that->typesize) || (thiz->size != that->size))
+		return 0;
+	if ((thiz->shift == that->shift) && (thiz->size > 0)) {
+		// same segment layout, compare segment by segment
+		for (i = 0; i < thiz->count; ++i) {
+			if (csegvector_segment_used(thiz, i) == 0)
+				break;
+			if (memcmp(thiz->segments[i], that->segments[i], csegvector_segment_used(thiz, i) * thiz->typesize) != 0)
+				return 0;
+		}
+		return 1;
+	}
+	for (i = 0; i < thiz->size; ++i) {
+		if (memcmp(csegvector_segment_locate(thiz, i), csegvector_segment_locate(that, i), thiz->typesize) != 0)
+			return 0;
+	}
+	return 1;
+}
+
+/*   csegvector_alloc: malloc csegvector pointer
+ *   size:     first segment item count, rounded up to a power of two
+ *   typesize: item size
+ *   return: csegvector pointer
+ */
+csegvector* csegvector_alloc(uint64_t size, uint64_t typesize) {
+	csegvector *thiz = NULL;
+	csegvector_data *thiz_data = NULL;
+	if ((size <= 0) || (typesize <= 0) || (size > (1ULL << 32)))
+		return NULL;
+
+	thiz_data = (csegvector_data *)malloc(sizeof(csegvector_data));
+	if (thiz_data == NULL)
+		return NULL;
+	thiz_data->count    = 0;
+	thiz_data->size     = 0;
+	thiz_data->typesize = typesize;
+	thiz_data->shift    = (size > 1) ? (64 - __builtin_clzll(size - 1)) : 0;
+	thiz_data->last     = NULL;
+	thiz_data->final    = NULL;
+	if (csegvector_segment_add(thiz_data) != 0) {
+		free(thiz_data);
+		return NULL;
+	}
+
+	thiz = (csegvector*) &(thiz_data->vector);
+	thiz->clear  = csegvector_static_clear;
+	thiz->free  = csegvector_static_free;
+	thiz->typesize  = csegvector_static_typesize;
+	thiz->size  = csegvector_static_size;
+	thiz->capacity  = csegvector_static_capacity;
+	thiz->empty  = csegvector_static_empty;
+	thiz->resize  = csegvector_static_resize;
+	thiz->reserve  = csegvector_static_reserve;
+	thiz->back  = csegvector_static_back;
+	thiz->front  = csegvector_static_front;
+	thiz->at  = csegvector_static_at;
+	thiz->segment  = csegvector_static_segment;
+	thiz->push_back  = csegvector_static_push_back;
+	thiz->pop_back  = csegvector_static_pop_back;
+	thiz->emplace_back  = csegvector_static_emplace_back;
+	thiz->push_back_n  = csegvector_static_push_back_n;
+	thiz->find  = csegvector_static_find;
+	thiz->copy  = csegvector_static_copy;
+	thiz->equal  = csegvector_static_equal;
+	return thiz;
+}
\ No newline at end of file
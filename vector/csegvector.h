@@ -0,0 +1,161 @@
+#ifndef CSEGVECTOR_H_INCLUDED
+#define CSEGVECTOR_H_INCLUDED
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+struct csegvector_t;
+typedef struct csegvector_t csegvector;
+
+// segmented vector, items never move once added
+// segment k holds first_count << k items, a new segment is added when all are full
+// index i lives in segment k = log2(i + first_count) - log2(first_count)
+// directory
+// +-----+-----+-----+-----+
+// |  0  |  1  |  2  | ... |
+// +-----+-----+-----+-----+
+//    |     |     |
+//    V     V     V
+// +----+ +------+ +------------+
+// |    | |      | |            |
+// +----+ +------+ +------------+
+// |<----------capacity()--------->|
+struct csegvector_t {
+/*   clear: clear data, but not free
+ *   thiz: csegvector pointer
+ */
+    void      (*clear)(csegvector *thiz);
+
+/*   free: free thiz and segments
+ *   thiz: csegvector pointer
+ */
+    void      (*free)(csegvector *thiz);
+
+/*   typesize: get item size
+ *   thiz: csegvector pointer
+ *   return  item size > 0
+ */
+    uint64_t  (*typesize)(csegvector *thiz);
+
+/*   size: get item count
+ *   thiz: csegvector pointer
+ *   return  item count
+ */
+    uint64_t  (*size)(csegvector *thiz);
+
+/*   capacity: get item count of the allocated segments
+ *   thiz: csegvector pointer
+ *   return  max item count before a new segment
+ */
+    uint64_t  (*capacity)(csegvector *thiz);
+
+/*   empty: item count == 0
+ *   thiz: csegvector pointer
+ *   return  item count == 0
+ */
+    uint8_t   (*empty)(csegvector *thiz);
+
+/*   resize: set n items equal val
+ *   thiz: csegvector pointer
+ *   n:    n items  equal val
+ *   val:  item pointer
+ */
+    void      (*resize)(csegvector *thiz, uint64_t n, const void* val);
+
+/*   reserve: add segments until capacity items fit
+ *   thiz: csegvector pointer
+ *   capacity:   max item count
+ */
+    void      (*reserve)(csegvector *thiz, uint64_t capacity);
+
+/*   back: last item pointer
+ *   thiz: csegvector pointer
+ *   return last item pointer, NULL if empty
+ */
+    void*     (*back)(csegvector *thiz);
+
+/*   front: first item pointer
+ *   thiz: csegvector pointer
+ *   return first item pointer, NULL if empty
+ */
+    void*     (*front)(csegvector *thiz);
+
+/*   at: index item pointer, stable until the item is popped or thiz is freed
+ *   thiz: csegvector pointer
+ *   index: item index
+ *   return index item pointer, NULL if index >= size
+ */
+    void*     (*at)(csegvector *thiz, uint64_t index);
+
+/*   segment: items of one segment, contiguous
+ *   thiz: csegvector pointer
+ *   index: segment index
+ *   count: set used item count of the segment
+ *   return first item pointer, NULL if the segment holds no item
+ */
+    void*     (*segment)(csegvector *thiz, uint64_t index, uint64_t *count);
+
+/*   push_back: add last item
+ *   thiz: csegvector pointer
+ *   val:  item pointer
+ */
+    void      (*push_back)(csegvector *thiz, const void* val);
+
+/*   pop_back: delete last item, its segment is kept
+ *   thiz: csegvector pointer
+ */
+    void      (*pop_back)(csegvector *thiz);
+
+/*   emplace_back: add an uninitialized last item
+ *   thiz: csegvector pointer
+ *   return new item pointer, NULL if out of memory
+ */
+    void*     (*emplace_back)(csegvector *thiz);
+
+/*   push_back_n: add n items behind, copied from src
+ *   thiz: csegvector pointer
+ *   src:  first item pointer, contiguous
+ *   n:    item count
+ */
+    void      (*push_back_n)(csegvector *thiz, const void* src, uint64_t n);
+
+/*   find: first item equal val
+ *   thiz: csegvector pointer
+ *   val:  item pointer
+ *   return item pointer, NULL if not found
+ */
+    void*     (*find)(csegvector *thiz, const void* val);
+
+/*   copy: copy thiz items to that
+ *   thiz: csegvector pointer
+ *   that: csegvector pointer
+ */
+    void      (*copy)(csegvector *thiz, csegvector *that);
+
+/*   equal: item count and items equal
+ *   thiz: csegvector pointer
+ *   that: csegvector pointer
+ *   return 1 if equal
+ */
+    uint8_t   (*equal)(csegvector *thiz, csegvector *that);
+};
+
+/*   csegvector_alloc: malloc csegvector pointer
+ *   size:     first segment item count, rounded up to a power of two
+ *   typesize: item size
+ *   return: csegvector pointer
+ */
+csegvector* csegvector_alloc(uint64_t size, uint64_t typesize);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
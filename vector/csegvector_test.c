@@ -0,0 +1,111 @@
+#include  <stddef.h>
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdlib.h>
+#include  <string.h>
+
+#include  "csegvector.h"
+
+static void test_print(csegvector *vec) {
+    uint64_t i;
+    void *it = NULL;
+    printf("%lld %lld %lld %d\n", vec->size(vec), vec->typesize(vec), vec->capacity(vec), vec->empty(vec));
+    for (i = 0; i < vec->size(vec); ++i) {
+    	int value = *((int*) vec->at(vec, i));
+    	printf("%x ", value);
+    }
+
+    printf("\n");
+    it = vec->front(vec);
+    if (it != NULL) {
+    	int front = *((int*) it);
+        printf("front:%x\n",front);
+    }
+
+    it = vec->back(vec);
+    if (it != NULL) {
+    	int back = *((int*) it);
+        printf("back:%x\n",back);
+    }
+}
+
+static void test_segvector1();
+
+static void test_segvector2();
+
+static void test_segvector3();
+
+int main(int argc, const char *argv[]) {
+	test_segvector1();
+	test_segvector2();
+	test_segvector3();
+	return 0;
+}
+
+void test_segvector1() {
+    printf("test push_back\n");
+    int buf[] = {0x01, 0x12, 0x23, 0x34, 0x45};
+    int i;
+    csegvector *vec = csegvector_alloc(2, sizeof(int));
+    for (i = 0; i < 5; ++i) {
+        vec->push_back(vec, &buf[i]);
+    }
+    test_print(vec);
+    vec->push_back_n(vec, buf, 5);
+    test_print(vec);
+    vec->pop_back(vec);
+    vec->pop_back(vec);
+    test_print(vec);
+    vec->resize(vec, 3, &buf[1]);
+    test_print(vec);
+    vec->clear(vec);
+    test_print(vec);
+    vec->free(vec);
+}
+
+void test_segvector2() {
+    printf("test stable\n");
+    int i, *first, *middle;
+    uint64_t k, count;
+    csegvector *vec = csegvector_alloc(4, sizeof(int));
+    i = 7;
+    vec->push_back(vec, &i);
+    first = vec->at(vec, 0);
+    for (i = 1; i < 1000; ++i) {
+        vec->push_back(vec, &i);
+    }
+    middle = vec->at(vec, 500);
+    for (i = 0; i < 100000; ++i) {
+        vec->push_back(vec, &i);
+    }
+    printf("%d %d %d\n", first == vec->at(vec, 0), *first, *middle);
+    for (k = 0; vec->segment(vec, k, &count) != NULL; ++k) {
+        printf("%llu ", (unsigned long long) count);
+    }
+    printf("\n");
+    i = 99999;
+    printf("%d\n", vec->find(vec, &i) == vec->back(vec));
+    vec->free(vec);
+}
+
+void test_segvector3() {
+    printf("test copy\n");
+    int i;
+    csegvector *vec1 = csegvector_alloc(1, sizeof(int));
+    csegvector *vec2 = csegvector_alloc(8, sizeof(int));
+    for (i = 0; i < 20; ++i) {
+        vec1->push_back(vec1, &i);
+    }
+    vec1->copy(vec1, vec2);
+    test_print(vec2);
+    printf("%d ", vec1->equal(vec1, vec2));
+    vec2->pop_back(vec2);
+    printf("%d\n", vec1->equal(vec1, vec2));
+    vec1->clear(vec1);
+    vec1->copy(vec1, vec2);
+    i = 0x42;
+    vec2->push_back(vec2, &i);
+    test_print(vec2);
+    vec1->free(vec1);
+    vec2->free(vec2);
+}
\ No newline at end of file
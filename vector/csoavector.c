@@ -0,0 +1,351 @@
+#include <string.h>
+#include <stdlib.h>
+#include "csoavector.h"
+#include "cvector.h"
+
+struct csoavector_data_t {
+	csoavector                 vector;
+    uint64_t                   typesize;
+    uint64_t                   fields;
+    uint64_t                   size;
+    uint64_t*                  offsets;
+    uint64_t*                  widths;
+    cvector**                  columns;
+};
+
+typedef struct csoavector_data_t  csoavector_data;
+
+
+/*   column_trim: drop column items behind size, undo a push that failed on a later column
+ *   thiz: csoavector data pointer
+ *   count: column count to trim
+ */
+static    void    csoavector_column_trim(csoavector_data *thiz, uint64_t count) {
+	uint64_t k;
+	cvector *column = NULL;
+	for (k = 0; k < count; ++k) {
+		column = thiz->columns[k];
+		if (cvector_fast_size(column) > thiz->size)
+			column->erase(column, column->at(column, thiz->size), column->end(column));
+	}
+}
+
+
+/*   clear: clear data, but not free
+ *   thiz: csoavector pointer
+ */
+static    void    csoavector_static_clear(csoavector *_thiz) {
+	uint64_t k;
+	csoavector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return;
+	thiz = (csoavector_data*) _thiz;
+	for (k = 0; k < thiz->fields; ++k)
+		thiz->columns[k]->clear(thiz->columns[k]);
+	thiz->size = 0;
+}
+
+/*   free: free thiz and columns
+ *   thiz: csoavector pointer
+ */
+static    void    csoavector_static_free(csoavector *_thiz) {
+	uint64_t k;
+	csoavector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return;
+	thiz = (csoavector_data*) _thiz;
+	for (k = 0; k < thiz->fields; ++k) {
+		if (thiz->columns[k] != NULL)
+			thiz->columns[k]->free(thiz->columns[k]);
+	}
+	free(thiz);
+}
+
+/*   typesize: get record size
+ *   thiz: csoavector pointer
+ *   return  record size > 0
+ */
+static uint64_t    csoavector_static_typesize(csoavector *_thiz) {
+	if (_thiz == NULL)
+		return 0;
+	return ((csoavector_data*) _thiz)->typesize;
+}
+
+/*   fields: get field count
+ *   thiz: csoavector pointer
+ *   return  column count > 0
+ */
+static uint64_t    csoavector_static_fields(csoavector *_thiz) {
+	if (_thiz == NULL)
+		return 0;
+	return ((csoavector_data*) _thiz)->fields;
+}
+
+/*   size: get row count
+ *   thiz: csoavector pointer
+ *   return  row count
+ */
+static uint64_t    csoavector_static_size(csoavector *_thiz) {
+	if (_thiz == NULL)
+		return 0;
+	return ((csoavector_data*) _thiz)->size;
+}
+
+/*   capacity: get row count every column holds without growing
+ *   thiz: csoavector pointer
+ *   return  max row count
+ */
+static uint64_t    csoavector_static_capacity(csoavector *_thiz) {
+	uint64_t k, capacity, min = UINT64_MAX;
+	csoavector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return 0;
+	thiz = (csoavector_data*) _thiz;
+	for (k = 0; k < thiz->fields; ++k) {
+		capacity = thiz->columns[k]->capacity(thiz->columns[k]);
+		if (capacity < min)
+			min = capacity;
+	}
+	return min;
+}
+
+/*   empty: row count == 0
+ *   thiz: csoavector pointer
+ *   return  row count == 0
+ */
+static uint8_t    csoavector_static_empty(csoavector *_thiz) {
+	if (_thiz == NULL)
+		return 0;
+	return (((csoavector_data*) _thiz)->size == 0) ? 1 : 0;
+}
+
+/*   reserve: change capacity of every column
+ *   thiz: csoavector pointer
+ *   capacity:   max row count
+ */
+static    void    csoavector_static_reserve(csoavector *_thiz, uint64_t capacity) {
+	uint64_t k;
+	csoavector_data *thiz = NULL;
+	if ((_thiz == NULL) || (capacity <= 0))
+		return;
+	thiz = (csoavector_data*) _thiz;
+	if (capacity < thiz->size)
+		return;
+	for (k = 0; k < thiz->fields; ++k)
+		thiz->columns[k]->reserve(thiz->columns[k], capacity);
+}
+
+/*   at: gather index row into record
+ *   thiz: csoavector pointer
+ *   index: row index
+ *   record: record pointer, typesize bytes, bytes outside fields are left as is
+ *   return record, NULL if index >= size
+ */
+static    void*    csoavector_static_at(csoavector *_thiz, uint64_t index, void* record) {
+	uint64_t k;
+	csoavector_data *thiz = NULL;
+	if ((_thiz == NULL) || (record == NULL))
+		return NULL;
+	thiz = (csoavector_data*) _thiz;
+	if (index >= thiz->size)
+		return NULL;
+	for (k = 0; k < thiz->fields; ++k)
+		memcpy(record + thiz->offsets[k], cvector_fast_at(thiz->columns[k], index), thiz->widths[k]);
+	return record;
+}
+
+/*   set: scatter record into index row
+ *   thiz: csoavector pointer
+ *   index: row index
+ *   record: record pointer
+ */
+static    void    csoavector_static_set(csoavector *_thiz, uint64_t index, const void* record) {
+	uint64_t k;
+	csoavector_data *thiz = NULL;
+	if ((_thiz == NULL) || (record == NULL))
+		return;
+	thiz = (csoavector_data*) _thiz;
+	if (index >= thiz->size)
+		return;
+	for (k = 0; k < thiz->fields; ++k)
+		memcpy(cvector_fast_at(thiz->columns[k], index), record + thiz->offsets[k], thiz->widths[k]);
+}
+
+/*   item: field pointer of index row
+ *   thiz: csoavector pointer
+ *   field: field index
+ *   index: row index
+ *   return field pointer, valid until the next push, NULL if out of range
+ */
+static    void*    csoavector_static_item(csoavector *_thiz, uint64_t field, uint64_t index) {
+	csoavector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return NULL;
+	thiz = (csoavector_data*) _thiz;
+	if ((field >= thiz->fields) || (index >= thiz->size))
+		return NULL;
+	return cvector_fast_at(thiz->columns[field], index);
+}
+
+/*   column: first item of one field column
+ *   thiz: csoavector pointer
+ *   field: field index
+ *   return first item pointer, NULL if out of range or empty
+ */
+static    void*    csoavector_static_column(csoavector *_thiz, uint64_t field) {
+	csoavector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return NULL;
+	thiz = (csoavector_data*) _thiz;
+	if ((field >= thiz->fields) || (thiz->size == 0))
+		return NULL;
+	return cvector_fast_data(thiz->columns[field]);
+}
+
+/*   push_back: add last row
+ *   thiz: csoavector pointer
+ *   record: record pointer
+ */
+static    void    csoavector_static_push_back(csoavector *_thiz, const void* record) {
+	uint64_t k;
+	void* ptr = NULL;
+	csoavector_data *thiz = NULL;
+	if ((_thiz == NULL) || (record == NULL))
+		return;
+	thiz = (csoavector_data*) _thiz;
+	for (k = 0; k < thiz->fields; ++k) {
+		ptr = thiz->columns[k]->emplace_back(thiz->columns[k]);
+		if (ptr == NULL) {
+			csoavector_column_trim(thiz, k);
+			return;
+		}
+		memcpy(ptr, record + thiz->offsets[k], thiz->widths[k]);
+	}
+	thiz->size = thiz->size + 1;
+}
+
+/*   push_back_n: add n rows, copied from records
+ *   thiz: csoavector pointer
+ *   src:  first record pointer, contiguous
+ *   n:    row count
+ */
+static    void    csoavector_static_push_back_n(csoavector *_thiz, const void* src, uint64_t n) {
+	uint64_t i, k, width, offset;
+	void* ptr = NULL;
+	csoavector_data *thiz = NULL;
+	if ((_thiz == NULL) || (src == NULL) || (n <= 0))
+		return;
+	thiz = (csoavector_data*) _thiz;
+	// column by column, each column is written front to back once
+	for (k = 0; k < thiz->fields; ++k) {
+		ptr = thiz->columns[k]->append_uninitialized(thiz->columns[k], n);
+		if (ptr == NULL) {
+			csoavector_column_trim(thiz, k);
+			return;
+		}
+		width  = thiz->widths[k];
+		offset = thiz->offsets[k];
+		for (i = 0; i < n; ++i)
+			memcpy(ptr + i * width, src + i * thiz->typesize + offset, width);
+	}
+	thiz->size = thiz->size + n;
+}
+
+/*   pop_back: delete last row
+ *   thiz: csoavector pointer
+ */
+static    void    csoavector_static_pop_back(csoavector *_thiz) {
+	uint64_t k;
+	csoavector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return;
+	thiz = (csoavector_data*) _thiz;
+	if (thiz->size == 0)
+		return;
+	for (k = 0; k < thiz->fields; ++k)
+		thiz->columns[k]->pop_back(thiz->columns[k]);
+	thiz->size = thiz->size - 1;
+}
+
+/*   erase: delete rows from first to last
+ *   thiz: csoavector pointer
+ *   first: begin row index
+ *   last: end row index, not deleted
+ */
+static    void    csoavector_static_erase(csoavector *_thiz, uint64_t first, uint64_t last) {
+	uint64_t k;
+	cvector *column = NULL;
+	csoavector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return;
+	thiz = (csoavector_data*) _thiz;
+	if (last > thiz->size)
+		last = thiz->size;
+	if (first >= last)
+		return;
+	for (k = 0; k < thiz->fields; ++k) {
+		column = thiz->columns[k];
+		column->erase(column, cvector_fast_at(column, first), cvector_fast_at(column, first) + (last - first) * thiz->widths[k]);
+	}
+	thiz->size = thiz->size - (last - first);
+}
+
+/*   csoavector_alloc: malloc csoavector pointer
+ *   size:     row count
+ *   typesize: record size
+ *   fields:   field count
+ *   offsets:  field offsets in the record
+ *   widths:   field sizes, offsets[k] + widths[k] <= typesize
+ *   return: csoavector pointer, NULL if a field is out of the record
+ */
+csoavector* csoavector_alloc(uint64_t size, uint64_t typesize, uint64_t fields, const uint64_t *offsets, const uint64_t *widths) {
+	uint64_t k;
+	csoavector *thiz = NULL;
+	csoavector_data *thiz_data = NULL;
+	if ((size <= 0) || (typesize <= 0) || (fields <= 0) || (offsets == NULL) || (widths == NULL))
+		return NULL;
+	for (k = 0; k < fields; ++k) {
+		if ((widths[k] <= 0) || (offsets[k] >= typesize) || (widths[k] > typesize - offsets[k]))
+			return NULL;
+	}
+
+	// offsets, widths and columns follow the data struct in one block
+	thiz_data = (csoavector_data *)malloc(sizeof(csoavector_data) + fields * (2 * sizeof(uint64_t) + sizeof(cvector*)));
+	if (thiz_data == NULL)
+		return NULL;
+	thiz_data->typesize = typesize;
+	thiz_data->fields   = fields;
+	thiz_data->size     = 0;
+	thiz_data->offsets  = (uint64_t*) (thiz_data + 1);
+	thiz_data->widths   = thiz_data->offsets + fields;
+	thiz_data->columns  = (cvector**) (thiz_data->widths + fields);
+	memcpy(thiz_data->offsets, offsets, fields * sizeof(uint64_t));
+	memcpy(thiz_data->widths, widths, fields * sizeof(uint64_t));
+	for (k = 0; k < fields; ++k)
+		thiz_data->columns[k] = cvector_alloc(size, widths[k]);
+
+	thiz = (csoavector*) &(thiz_data->vector);
+	thiz->clear  = csoavector_static_clear;
+	thiz->free  = csoavector_static_free;
+	for (k = 0; k < fields; ++k) {
+		if (thiz_data->columns[k] == NULL) {
+			thiz->free(thiz);
+			return NULL;
+		}
+	}
+	thiz->typesize  = csoavector_static_typesize;
+	thiz->fields  = csoavector_static_fields;
+	thiz->size  = csoavector_static_size;
+	thiz->capacity  = csoavector_static_capacity;
+	thiz->empty  = csoavector_static_empty;
+	thiz->reserve  = csoavector_static_reserve;
+	thiz->at  = csoavector_static_at;
+	thiz->set  = csoavector_static_set;
+	thiz->item  = csoavector_static_item;
+	thiz->column  = csoavector_static_column;
+	thiz->push_back  = csoavector_static_push_back;
+	thiz->push_back_n  = csoavector_static_push_back_n;
+	thiz->pop_back  = csoavector_static_pop_back;
+	thiz->erase  = csoavector_static_erase;
+	return thiz;
+}
\ No newline at end of file
@@ -0,0 +1,146 @@
+#ifndef CSOAVECTOR_H_INCLUDED
+#define CSOAVECTOR_H_INCLUDED
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+struct csoavector_t;
+typedef struct csoavector_t csoavector;
+
+// struct of arrays vector, each field of a record lives in its own cvector column
+// rows are scattered from and gathered to records of typesize bytes,
+// field k is widths[k] bytes at offsets[k] of the record
+// record              columns
+// +---+-------+---+   +---+---+---+---+
+// | a |   b   | c |-->| a | a | a |...|  column 0
+// +---+-------+---+   +---+---+---+---+
+//                     |   b   |   b   |...  column 1
+//                     +---+---+---+---+
+//                     | c | c | c |...|  column 2
+//                     +---+---+---+---+
+// a scan of one field only touches its column
+struct csoavector_t {
+/*   clear: clear data, but not free
+ *   thiz: csoavector pointer
+ */
+    void      (*clear)(csoavector *thiz);
+
+/*   free: free thiz and columns
+ *   thiz: csoavector pointer
+ */
+    void      (*free)(csoavector *thiz);
+
+/*   typesize: get record size
+ *   thiz: csoavector pointer
+ *   return  record size > 0
+ */
+    uint64_t  (*typesize)(csoavector *thiz);
+
+/*   fields: get field count
+ *   thiz: csoavector pointer
+ *   return  column count > 0
+ */
+    uint64_t  (*fields)(csoavector *thiz);
+
+/*   size: get row count
+ *   thiz: csoavector pointer
+ *   return  row count
+ */
+    uint64_t  (*size)(csoavector *thiz);
+
+/*   capacity: get row count every column holds without growing
+ *   thiz: csoavector pointer
+ *   return  max row count
+ */
+    uint64_t  (*capacity)(csoavector *thiz);
+
+/*   empty: row count == 0
+ *   thiz: csoavector pointer
+ *   return  row count == 0
+ */
+    uint8_t   (*empty)(csoavector *thiz);
+
+/*   reserve: change capacity of every column
+ *   thiz: csoavector pointer
+ *   capacity:   max row count
+ */
+    void      (*reserve)(csoavector *thiz, uint64_t capacity);
+
+/*   at: gather index row into record
+ *   thiz: csoavector pointer
+ *   index: row index
+ *   record: record pointer, typesize bytes, bytes outside fields are left as is
+ *   return record, NULL if index >= size
+ */
+    void*     (*at)(csoavector *thiz, uint64_t index, void* record);
+
+/*   set: scatter record into index row
+ *   thiz: csoavector pointer
+ *   index: row index
+ *   record: record pointer
+ */
+    void      (*set)(csoavector *thiz, uint64_t index, const void* record);
+
+/*   item: field pointer of index row
+ *   thiz: csoavector pointer
+ *   field: field index
+ *   index: row index
+ *   return field pointer, valid until the next push, NULL if out of range
+ */
+    void*     (*item)(csoavector *thiz, uint64_t field, uint64_t index);
+
+/*   column: first item of one field column, size items of widths[field] bytes
+ *   thiz: csoavector pointer
+ *   field: field index
+ *   return first item pointer, valid until the next push, NULL if out of range or empty
+ */
+    void*     (*column)(csoavector *thiz, uint64_t field);
+
+/*   push_back: add last row
+ *   thiz: csoavector pointer
+ *   record: record pointer
+ */
+    void      (*push_back)(csoavector *thiz, const void* record);
+
+/*   push_back_n: add n rows, copied from records
+ *   thiz: csoavector pointer
+ *   src:  first record pointer, contiguous
+ *   n:    row count
+ */
+    void      (*push_back_n)(csoavector *thiz, const void* src, uint64_t n);
+
+/*   pop_back: delete last row
+ *   thiz: csoavector pointer
+ */
+    void      (*pop_back)(csoavector *thiz);
+
+/*   erase: delete rows from first to last
+ *   thiz: csoavector pointer
+ *   first: begin row index
+ *   last: end row index, not deleted
+ */
+    void      (*erase)(csoavector *thiz, uint64_t first, uint64_t last);
+};
+
+/*   csoavector_alloc: malloc csoavector pointer
+ *   size:     row count
+ *   typesize: record size
+ *   fields:   field count
+ *   offsets:  field offsets in the record
+ *   widths:   field sizes, offsets[k] + widths[k] <= typesize
+ *   return: csoavector pointer, NULL if a field is out of the record
+ */
+csoavector* csoavector_alloc(uint64_t size, uint64_t typesize, uint64_t fields, const uint64_t *offsets, const uint64_t *widths);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
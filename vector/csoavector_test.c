@@ -0,0 +1,85 @@
+#include  <stddef.h>
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdlib.h>
+#include  <string.h>
+
+#include  "csoavector.h"
+
+struct test_record_t {
+    uint8_t   tag;
+    uint32_t  id;
+    uint64_t  value;
+};
+
+static const uint64_t test_offsets[] = {offsetof(struct test_record_t, tag), offsetof(struct test_record_t, id), offsetof(struct test_record_t, value)};
+
+static const uint64_t test_widths[] = {sizeof(uint8_t), sizeof(uint32_t), sizeof(uint64_t)};
+
+static void test_print(csoavector *vec) {
+    uint64_t i;
+    struct test_record_t record;
+    printf("%lld %lld %lld %d\n", vec->size(vec), vec->typesize(vec), vec->fields(vec), vec->empty(vec));
+    for (i = 0; i < vec->size(vec); ++i) {
+        vec->at(vec, i, &record);
+        printf("%x:%x:%llx ", record.tag, record.id, (unsigned long long) record.value);
+    }
+    printf("\n");
+}
+
+static void test_soavector1();
+
+static void test_soavector2();
+
+int main(int argc, const char *argv[]) {
+	test_soavector1();
+	test_soavector2();
+	return 0;
+}
+
+void test_soavector1() {
+    printf("test push_back, erase\n");
+    struct test_record_t buf[5];
+    int i;
+    csoavector *vec = csoavector_alloc(2, sizeof(struct test_record_t), 3, test_offsets, test_widths);
+    for (i = 0; i < 5; ++i) {
+        buf[i].tag   = i;
+        buf[i].id    = 0x10 * i;
+        buf[i].value = 0x100 * i;
+        vec->push_back(vec, &buf[i]);
+    }
+    test_print(vec);
+    vec->push_back_n(vec, buf, 5);
+    test_print(vec);
+    vec->erase(vec, 1, 7);
+    vec->pop_back(vec);
+    test_print(vec);
+    buf[0].id = 0x77;
+    vec->set(vec, 0, &buf[0]);
+    test_print(vec);
+    vec->clear(vec);
+    test_print(vec);
+    vec->free(vec);
+}
+
+void test_soavector2() {
+    printf("test column\n");
+    struct test_record_t record;
+    uint64_t i, sum = 0, *value;
+    uint32_t *id;
+    csoavector *vec = csoavector_alloc(4, sizeof(struct test_record_t), 3, test_offsets, test_widths);
+    memset(&record, 0, sizeof(record));
+    for (i = 0; i < 100; ++i) {
+        record.id    = i;
+        record.value = i * 2;
+        vec->push_back(vec, &record);
+    }
+    id    = vec->column(vec, 1);
+    value = vec->column(vec, 2);
+    for (i = 0; i < vec->size(vec); ++i) {
+        sum += id[i] + value[i];
+    }
+    printf("%llu %d %d\n", (unsigned long long) sum, *((uint32_t*) vec->item(vec, 1, 42)) == 42, vec->item(vec, 3, 0) == NULL);
+    printf("%d\n", csoavector_alloc(4, 12, 1, &test_offsets[2], &test_widths[2]) == NULL);
+    vec->free(vec);
+}
\ No newline at end of file
@@ -1,26 +1,642 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
 #include <string.h>
 #include <stdlib.h>
+#include <stdatomic.h>
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 #include "cvector.h"
+#include "cvector_algo.h"
+
+// buffers at least this large are page mapped and grow with mremap
+#ifndef CVECTOR_MMAP_THRESHOLD
+#define CVECTOR_MMAP_THRESHOLD  (64ULL << 20)
+#endif
 
 // vector
-// first                last             end
-// |                     |               |
-// V                     V               V
-// +-------------------------------------+
-// |    ... data ...     |               |
-// +-------------------------------------+
-// |<--------size()----->|
-// |<---------------capacity()---------->|
+// base      first                last             end
+// |         |                     |               |
+// V         V                     V               V
+// +-----------------------------------------------+
+// |  slack  |    ... data ...     |               |
+// +-----------------------------------------------+
+//           |<--------size()----->|
+//           |<---------------capacity()---------->|
+// base == first unless slack mode keeps free items before first
+// incremental mode, while pending != NULL
+// first     first + migrated    first + migrate_end   last
+// |         |                   |                     |
+// V         V                   V                     V
+// +-----------------------------------------------------------+
+// | moved   | still in pending  | pushed after growth |       |
+// +-----------------------------------------------------------+
+// buffer shared with snapshots, freed by the last owner
+struct cvector_share_t {
+    _Atomic uint64_t           refs;
+    void*                      base;
+    uint64_t                   size;
+    uint8_t                    storage;
+};
+
+typedef struct cvector_share_t  cvector_share;
+
 struct cvector_data_t {
 	cvector                    vector;
     void*                      first;
     void*                      last;
     void*                      final;
     uint64_t                   typesize;
+    void*                      pending;
+    void*                      base;
+    uint64_t                   growth;
+    uint64_t                   step;
+    uint64_t                   inline_size;
+    uint64_t                   pending_size;
+    uint64_t                   pending_offset;
+    uint64_t                   migrated;
+    uint64_t                   migrate_end;
+    uint64_t                   migrate_step;
+    cvector_share*             share;
+    uint8_t                    storage;
+    uint8_t                    pending_storage;
+    uint8_t                    slack;
+    uint8_t                    readonly;
 };
 
 typedef struct cvector_data_t  cvector_data;
 
+// buffer storage
+// HEAP:   malloc buffer
+// MAPPED: mmap buffer, grows with mremap
+// INLINE: inline_size bytes behind cvector_data, same allocation, never freed alone
+#define CVECTOR_BUFFER_HEAP     0
+#define CVECTOR_BUFFER_MAPPED   1
+#define CVECTOR_BUFFER_INLINE   2
+
+// inline buffer offset from cvector_data, 16 byte aligned as malloc
+#define CVECTOR_INLINE_OFFSET   ((sizeof(cvector_data) + 15) & ~((uint64_t) 15))
+
+// cvector_head in cvector.h mirrors the leading fields
+_Static_assert(offsetof(cvector_data, first)    == offsetof(cvector_head, first),    "cvector_head first");
+_Static_assert(offsetof(cvector_data, last)     == offsetof(cvector_head, last),     "cvector_head last");
+_Static_assert(offsetof(cvector_data, final)    == offsetof(cvector_head, final),    "cvector_head final");
+_Static_assert(offsetof(cvector_data, typesize) == offsetof(cvector_head, typesize), "cvector_head typesize");
+_Static_assert(offsetof(cvector_data, pending)  == offsetof(cvector_head, pending),  "cvector_head pending");
+
+
+/*   buffer_alloc: malloc size bytes, page mapped when size is large
+ *   size:    buffer bytes
+ *   storage: set CVECTOR_BUFFER_HEAP or CVECTOR_BUFFER_MAPPED
+ *   return buffer pointer, NULL if out of memory
+ */
+static    void*    cvector_buffer_alloc(uint64_t size, uint8_t *storage) {
+	void* ptr = NULL;
+	*storage = CVECTOR_BUFFER_HEAP;
+#ifdef __linux__
+	if (size >= CVECTOR_MMAP_THRESHOLD) {
+		ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (ptr == MAP_FAILED)
+			return NULL;
+		*storage = CVECTOR_BUFFER_MAPPED;
+		return ptr;
+	}
+#endif
+	return malloc(size);
+}
+
+/*   buffer_free: free buffer from buffer_alloc, inline buffer is kept
+ *   ptr:     buffer pointer
+ *   size:    buffer bytes
+ *   storage: buffer storage
+ */
+static    void    cvector_buffer_free(void* ptr, uint64_t size, uint8_t storage) {
+	if ((ptr == NULL) || (storage == CVECTOR_BUFFER_INLINE))
+		return;
+#ifdef __linux__
+	if (storage == CVECTOR_BUFFER_MAPPED) {
+		munmap(ptr, size);
+		return;
+	}
+#endif
+	free(ptr);
+}
+
+/*   buffer_realloc: change buffer to size bytes, keep data at the same offset from base
+ *   thiz: cvector data pointer
+ *   size: buffer bytes
+ *   return 0 if success, -1 if out of memory
+ */
+static    int    cvector_buffer_realloc(cvector_data *thiz, uint64_t size) {
+	uint64_t offset, used, capacity;
+	uint8_t storage = thiz->storage;
+	void* ptr = NULL;
+	offset   = thiz->first - thiz->base;
+	used     = thiz->last  - thiz->first;
+	capacity = thiz->final - thiz->base;
+	if (offset > size)
+		offset = size;
+	if (offset + used > size)
+		used = size - offset;
+
+	if (thiz->base == NULL) {
+		ptr = cvector_buffer_alloc(size, &storage);
+	} else if (storage == CVECTOR_BUFFER_INLINE) {
+		// stay inline while it fits, else spill to the heap
+		if (size <= thiz->inline_size) {
+			ptr = thiz->base;
+		} else {
+			ptr = cvector_buffer_alloc(size, &storage);
+			if ((ptr != NULL) && (used > 0))
+				memcpy(ptr + offset, thiz->first, used);
+		}
+#ifdef __linux__
+	} else if (storage == CVECTOR_BUFFER_MAPPED) {
+		ptr = mremap(thiz->base, capacity, size, MREMAP_MAYMOVE);
+		if (ptr == MAP_FAILED)
+			ptr = NULL;
+	} else if (size >= CVECTOR_MMAP_THRESHOLD) {
+		ptr = cvector_buffer_alloc(size, &storage);
+		if (ptr != NULL) {
+			if (used > 0)
+				memcpy(ptr + offset, thiz->first, used);
+			free(thiz->base);
+		}
+#endif
+	} else {
+		ptr = realloc(thiz->base, size);
+	}
+	if (ptr == NULL)
+		return -1;
+
+	thiz->base   = ptr;
+	thiz->first  = ptr + offset;
+	thiz->last   = ptr + offset + used;
+	thiz->final   = ptr + size;
+	thiz->storage = storage;
+	return 0;
+}
+
+/*   growth_capacity: new buffer bytes for growth policy
+ *   thiz: cvector data pointer
+ *   size: needed bytes
+ *   return buffer bytes >= size, 0 if the bytes overflow uint64_t
+ */
+static    uint64_t    cvector_growth_capacity(cvector_data *thiz, uint64_t size) {
+	uint64_t capacity = size, step, high, low;
+	switch (thiz->growth) {
+	case CVECTOR_GROWTH_STEP:
+		if (thiz->step > UINT64_MAX / thiz->typesize)
+			return 0;
+		step = thiz->step * thiz->typesize;
+		if (size > UINT64_MAX - (step - 1))
+			return 0;
+		capacity = (size + step - 1) / step * step;
+		break;
+	case CVECTOR_GROWTH_EXACT:
+		break;
+	default:
+		// size / 100 * step + size % 100 * step / 100, step > 100 keeps it above size
+		high = size / 100;
+		low  = size % 100;
+		if ((high > UINT64_MAX / thiz->step) || ((low > 0) && (thiz->step > UINT64_MAX / low)))
+			return 0;
+		high *= thiz->step;
+		low   = low * thiz->step / 100;
+		if (high > UINT64_MAX - low)
+			return 0;
+		capacity = high + low;
+		break;
+	}
+	// keep whole items
+	if (capacity > UINT64_MAX - (thiz->typesize - 1))
+		return 0;
+	return (capacity + thiz->typesize - 1) / thiz->typesize * thiz->typesize;
+}
+
+
+/*   share_release: drop one owner of a shared buffer, free it with the last one
+ *   share: share pointer
+ */
+static    void    cvector_share_release(cvector_share *share) {
+	if (atomic_fetch_sub_explicit(&share->refs, 1, memory_order_acq_rel) != 1)
+		return;
+	cvector_buffer_free(share->base, share->size, share->storage);
+	free(share);
+}
+
+/*   unshare: give thiz its own buffer before a change, snapshots keep the shared one
+ *   thiz: cvector data pointer
+ *   keep: 1 copies the items, 0 leaves the new buffer empty
+ *   return 0 if thiz may change, -1 if read only or out of memory
+ */
+static    int    cvector_unshare(cvector_data *thiz, uint8_t keep) {
+	uint64_t offset, used;
+	uint8_t storage = CVECTOR_BUFFER_HEAP;
+	void* ptr = NULL;
+	if (thiz->readonly)
+		return -1;
+	if (thiz->share == NULL)
+		return 0;
+	// no snapshot left, the buffer is ours again
+	if (atomic_load_explicit(&thiz->share->refs, memory_order_acquire) == 1) {
+		free(thiz->share);
+		thiz->share = NULL;
+		return 0;
+	}
+	offset = thiz->first - thiz->base;
+	used   = keep ? (uint64_t) (thiz->last - thiz->first) : 0;
+	ptr = cvector_buffer_alloc(thiz->final - thiz->base, &storage);
+	if (ptr == NULL)
+		return -1;
+	if (used > 0)
+		memcpy(ptr + offset, thiz->first, used);
+	cvector_share_release(thiz->share);
+	thiz->share   = NULL;
+	thiz->final   = ptr + (thiz->final - thiz->base);
+	thiz->base    = ptr;
+	thiz->first   = ptr + offset;
+	thiz->last    = ptr + offset + used;
+	thiz->storage = storage;
+	return 0;
+}
+
+/*   range_fill: copy n items equal val to dst
+ *   dst:  first item pointer
+ *   n:    n items  equal val
+ *   val:  item pointer, must not overlap dst
+ *   typesize: item size
+ */
+static    void    cvector_range_fill(void* dst, uint64_t n, const void* val, uint64_t typesize) {
+	uint64_t i, size, step;
+	switch (typesize) {
+	case 1:
+		memset(dst, *((const uint8_t*) val), n);
+		return;
+	case 2:
+		for (i = 0; i < n; ++i)
+			memcpy(dst + i * 2, val, 2);
+		return;
+	case 4:
+		for (i = 0; i < n; ++i)
+			memcpy(dst + i * 4, val, 4);
+		return;
+	case 8:
+		for (i = 0; i < n; ++i)
+			memcpy(dst + i * 8, val, 8);
+		return;
+	case 16:
+		for (i = 0; i < n; ++i)
+			memcpy(dst + i * 16, val, 16);
+		return;
+	default:
+		break;
+	}
+
+	// copy the first item, then double the filled prefix
+	size = n * typesize;
+	memcpy(dst, val, typesize);
+	for (step = typesize; step < size; step = step * 2) {
+		memcpy(dst + step, dst, (size - step < step) ? (size - step) : step);
+	}
+}
+
+/*   buffer_replace: drop data, malloc new size bytes buffer
+ *   thiz: cvector data pointer
+ *   size: buffer bytes
+ *   val:  n > 0: item pointer copied n times, n == 0: size bytes copied
+ *   n:    n items  equal val
+ *   return 0 if success, -1 if out of memory
+ */
+static    int    cvector_buffer_replace(cvector_data *thiz, uint64_t size, const void* val, uint64_t n) {
+	uint8_t storage = CVECTOR_BUFFER_HEAP;
+	void* ptr = cvector_buffer_alloc(size, &storage);
+	if (ptr == NULL)
+		return -1;
+	// val may live in the old buffer, copy before free
+	if (n > 0)
+		cvector_range_fill(ptr, n, val, thiz->typesize);
+	else
+		memcpy(ptr, val, size);
+	cvector_buffer_free(thiz->base, thiz->final - thiz->base, thiz->storage);
+	thiz->base    = ptr;
+	thiz->first   = ptr;
+	thiz->last    = ptr;
+	thiz->final   = ptr + size;
+	thiz->storage = storage;
+	return 0;
+}
+
+/*   migrate: move up to size bytes of items from the pending buffer, free it when empty
+ *   thiz: cvector data pointer
+ *   size: bytes to move
+ */
+static    void    cvector_migrate(cvector_data *thiz, uint64_t size) {
+	uint64_t left;
+	if (thiz->pending == NULL)
+		return;
+	left = thiz->migrate_end - thiz->migrated;
+	if (size > left)
+		size = left;
+	if (size > 0)
+		memcpy(thiz->first + thiz->migrated, thiz->pending + thiz->migrated, size);
+	thiz->migrated = thiz->migrated + size;
+	if (thiz->migrated < thiz->migrate_end)
+		return;
+	cvector_buffer_free(thiz->pending - thiz->pending_offset, thiz->pending_offset + thiz->pending_size, thiz->pending_storage);
+	thiz->pending = NULL;
+}
+
+/*   migrate_locate: item pointer at byte offset from first, in whichever buffer holds it
+ *   thiz:   cvector data pointer
+ *   offset: item byte offset
+ *   return item pointer
+ */
+static    void*    cvector_migrate_locate(cvector_data *thiz, uint64_t offset) {
+	if ((thiz->pending != NULL) && (offset >= thiz->migrated) && (offset < thiz->migrate_end))
+		return thiz->pending + offset;
+	return thiz->first + offset;
+}
+
+/*   migrate_rebase: map ptr into the pending buffer to the same item in the buffer
+ *   thiz: cvector data pointer
+ *   ptr:  item pointer or NULL
+ *   return item pointer in the buffer, ptr if it is not in pending
+ */
+static    void*    cvector_migrate_rebase(cvector_data *thiz, const void* ptr) {
+	if ((thiz->pending != NULL) && (ptr != NULL) && (ptr >= thiz->pending) && (ptr <= thiz->pending + thiz->migrate_end))
+		return thiz->first + (ptr - thiz->pending);
+	return (void*) ptr;
+}
+
+/*   settle: move every pending item, ptr into the pending buffer maps to the same item
+ *   thiz: cvector data pointer
+ *   ptr:  item pointer or NULL
+ *   return ptr, in the buffer when it pointed into pending
+ */
+static    void*    cvector_settle(cvector_data *thiz, void* ptr) {
+	if (thiz->pending == NULL)
+		return ptr;
+	ptr = cvector_migrate_rebase(thiz, ptr);
+	cvector_migrate(thiz, thiz->migrate_end);
+	return ptr;
+}
+
+/*   own: unshare before item pointers go out, writes through them must not reach snapshots
+ *   thiz: cvector data pointer
+ *   return 0 if the item pointers of thiz may be written, -1 if out of memory
+ */
+static inline int    cvector_own(cvector_data *thiz) {
+	if ((thiz->share == NULL) || thiz->readonly)
+		return 0;
+	cvector_settle(thiz, NULL);
+	return cvector_unshare(thiz, 1);
+}
+
+/*   range_defer: grow to a new buffer for size bytes behind last, items move later
+ *   thiz: cvector data pointer
+ *   size: gap bytes
+ *   return gap pointer, NULL if out of memory
+ */
+static    void*    cvector_range_defer(cvector_data *thiz, uint64_t size) {
+	uint64_t used, capacity;
+	uint8_t storage = CVECTOR_BUFFER_HEAP;
+	void* ptr = NULL;
+	used     = thiz->last - thiz->first;
+	capacity = cvector_growth_capacity(thiz, used + size);
+	if (capacity == 0)
+		return NULL;
+	ptr = cvector_buffer_alloc(capacity, &storage);
+	if (ptr == NULL)
+		return NULL;
+	// pending starts at first, a buffer taken from a slack vector has free items before it
+	thiz->pending         = thiz->first;
+	thiz->pending_size    = thiz->final - thiz->first;
+	thiz->pending_offset  = thiz->first - thiz->base;
+	thiz->pending_storage = thiz->storage;
+	thiz->migrated        = 0;
+	thiz->migrate_end     = used;
+	thiz->base    = ptr;
+	thiz->first   = ptr;
+	thiz->last    = ptr + used + size;
+	thiz->final   = ptr + capacity;
+	thiz->storage = storage;
+	cvector_migrate(thiz, thiz->migrate_step);
+	return ptr + used;
+}
+
+/*   range_center: make a gap of size bytes at pos, data centered in a buffer with free bytes at both ends
+ *   thiz: cvector data pointer
+ *   pos:  gap byte offset from first
+ *   size: gap bytes
+ *   return gap pointer, NULL if out of memory
+ */
+static    void*    cvector_range_center(cvector_data *thiz, uint64_t pos, uint64_t size) {
+	uint64_t used, capacity, offset;
+	uint8_t storage = CVECTOR_BUFFER_HEAP;
+	void* ptr = NULL;
+	used     = thiz->last  - thiz->first;
+	capacity = thiz->final - thiz->base;
+
+	// slide in place while at least half as many free bytes as data remain, else grow
+	if ((capacity - used >= size) && ((capacity - used - size) * 2 >= used + size)) {
+		offset = (capacity - used - size) / 2 / thiz->typesize * thiz->typesize;
+		ptr = thiz->base + offset;
+		memmove(ptr, thiz->first, used);
+		if (used > pos)
+			memmove(ptr + pos + size, ptr + pos, used - pos);
+		thiz->first = ptr;
+		thiz->last  = ptr + used + size;
+		return ptr + pos;
+	}
+
+	capacity = cvector_growth_capacity(thiz, used + size);
+	if (capacity == 0)
+		return NULL;
+	ptr = cvector_buffer_alloc(capacity, &storage);
+	if (ptr == NULL)
+		return NULL;
+	offset = (capacity - used - size) / 2 / thiz->typesize * thiz->typesize;
+	if (pos > 0)
+		memcpy(ptr + offset, thiz->first, pos);
+	if (used > pos)
+		memcpy(ptr + offset + pos + size, thiz->first + pos, used - pos);
+	cvector_buffer_free(thiz->base, thiz->final - thiz->base, thiz->storage);
+	thiz->base    = ptr;
+	thiz->first   = ptr + offset;
+	thiz->last    = ptr + offset + used + size;
+	thiz->final   = ptr + capacity;
+	thiz->storage = storage;
+	return thiz->first + pos;
+}
+
+/*   range_open_slack: make a gap of size bytes at pos, the shorter side moves
+ *   thiz: cvector data pointer
+ *   pos:  gap byte offset from first
+ *   size: gap bytes
+ *   return gap pointer, NULL if out of memory
+ */
+static    void*    cvector_range_open_slack(cvector_data *thiz, uint64_t pos, uint64_t size) {
+	uint64_t used, front, back;
+	used  = thiz->last  - thiz->first;
+	front = thiz->first - thiz->base;
+	back  = thiz->final - thiz->last;
+
+	// head moves before first
+	if (pos <= used - pos) {
+		if (front < size)
+			return cvector_range_center(thiz, pos, size);
+		if (pos > 0)
+			memmove(thiz->first - size, thiz->first, pos);
+		thiz->first = thiz->first - size;
+		return thiz->first + pos;
+	}
+	// tail moves behind last
+	if (back < size)
+		return cvector_range_center(thiz, pos, size);
+	memmove(thiz->first + pos + size, thiz->first + pos, used - pos);
+	thiz->last = thiz->last + size;
+	return thiz->first + pos;
+}
+
+/*   range_open: make a gap of size bytes at position, tail moves behind the gap
+ *   thiz: cvector data pointer
+ *   position: item pointer
+ *   size: gap bytes
+ *   return gap pointer, NULL if out of memory
+ */
+static    void*    cvector_range_open(cvector_data *thiz, void* position, uint64_t size) {
+	uint64_t pos, used, capacity;
+	pos  = position - thiz->first;
+	used = thiz->last - thiz->first;
+	if (cvector_unshare(thiz, 1) != 0)
+		return NULL;
+	position = thiz->first + pos;
+
+	if (thiz->slack)
+		return cvector_range_open_slack(thiz, pos, size);
+
+	// incremental mode, appends move a few pending items, growth defers the copy
+	if (thiz->migrate_step > 0) {
+		if (position != thiz->last)
+			position = cvector_settle(thiz, position);
+		else
+			cvector_migrate(thiz, thiz->migrate_step);
+		// the deferred gap is behind last, inserts before last grow at once
+		if ((position == thiz->last) && (used + size > (uint64_t) (thiz->final - thiz->first))) {
+			cvector_settle(thiz, NULL);
+			return cvector_range_defer(thiz, size);
+		}
+	}
+
+	if (used + size > (uint64_t) (thiz->final - thiz->first)) {
+		// a buffer taken from a slack vector keeps its free items before first
+		capacity = cvector_growth_capacity(thiz, used + size);
+		if ((capacity == 0) || (capacity > UINT64_MAX - (uint64_t) (thiz->first - thiz->base)))
+			return NULL;
+		if (cvector_buffer_realloc(thiz, (thiz->first - thiz->base) + capacity) != 0)
+			return NULL;
+		position = thiz->first + pos;
+	}
+
+	if (used > pos)
+		memmove(position + size, position, used - pos);
+	thiz->last = thiz->last + size;
+	return position;
+}
+
+/*   range_close: delete bytes from first to last, tail moves to first or head moves to last
+ *   thiz: cvector data pointer
+ *   first: begin item pointer
+ *   last: last item pointer
+ */
+static    void    cvector_range_close(cvector_data *thiz, void* first, void* last) {
+	uint64_t head = first - thiz->first, tail = thiz->last - last;
+	// slack mode moves the shorter side, head moves to last
+	if (thiz->slack && (head < tail)) {
+		if (head > 0)
+			memmove(thiz->first + (last - first), thiz->first, head);
+		thiz->first = thiz->first + (last - first);
+		return;
+	}
+	if (tail > 0)
+		memmove(first, last, tail);
+	thiz->last = first + tail;
+}
+
+/*   range_within: test whether ptr lies inside thiz buffer
+ *   thiz: cvector data pointer
+ *   ptr:  item pointer
+ *   return ptr in [base, final) or in the pending buffer
+ */
+static    uint8_t    cvector_range_within(cvector_data *thiz, const void* ptr) {
+	if ((thiz->pending != NULL) && (ptr >= thiz->pending) && (ptr < thiz->pending + thiz->pending_size))
+		return 1;
+	return ((ptr >= thiz->base) && (ptr < thiz->final)) ? 1 : 0;
+}
+
+
+/*   drop: free the buffers of thiz, snapshots keep a shared one
+ *   thiz: cvector data pointer
+ */
+static    void    cvector_drop(cvector_data *thiz) {
+	if (thiz->pending != NULL)
+		cvector_buffer_free(thiz->pending - thiz->pending_offset, thiz->pending_offset + thiz->pending_size, thiz->pending_storage);
+	thiz->pending = NULL;
+	if (thiz->share != NULL)
+		cvector_share_release(thiz->share);
+	else
+		cvector_buffer_free(thiz->base, thiz->final - thiz->base, thiz->storage);
+	thiz->share = NULL;
+}
+
+/*   detach: settle pending items and move inline items to the heap, the buffer may then change owner
+ *   thiz: cvector data pointer
+ *   return 0 if success, -1 if out of memory
+ */
+static    int    cvector_detach(cvector_data *thiz) {
+	uint8_t storage = CVECTOR_BUFFER_HEAP;
+	void* ptr = NULL;
+	cvector_settle(thiz, NULL);
+	if (thiz->storage != CVECTOR_BUFFER_INLINE)
+		return 0;
+	ptr = cvector_buffer_alloc(thiz->final - thiz->base, &storage);
+	if (ptr == NULL)
+		return -1;
+	if (thiz->last > thiz->first)
+		memcpy(ptr + (thiz->first - thiz->base), thiz->first, thiz->last - thiz->first);
+	thiz->final   = ptr + (thiz->final - thiz->base);
+	thiz->first   = ptr + (thiz->first - thiz->base);
+	thiz->last    = ptr + (thiz->last - thiz->base);
+	thiz->base    = ptr;
+	thiz->storage = storage;
+	return 0;
+}
+
+/*   empty_buffer: give thiz no items in its inline buffer, or in a new one item buffer
+ *   thiz: cvector data pointer
+ *   return 0 if success, -1 if out of memory
+ */
+static    int    cvector_empty_buffer(cvector_data *thiz) {
+	uint8_t storage = CVECTOR_BUFFER_INLINE;
+	void* ptr = (uint8_t*) thiz + CVECTOR_INLINE_OFFSET;
+	uint64_t size = thiz->inline_size / thiz->typesize * thiz->typesize;
+	if (size <= 0) {
+		size = thiz->typesize;
+		ptr  = cvector_buffer_alloc(size, &storage);
+		if (ptr == NULL)
+			return -1;
+	}
+	thiz->base    = ptr;
+	thiz->first   = ptr;
+	thiz->last    = ptr;
+	thiz->final   = ptr + size;
+	thiz->storage = storage;
+	thiz->share   = NULL;
+	return 0;
+}
 
 /*   clear: clear data, but not free
  *   thiz: cvector pointer
@@ -30,6 +646,14 @@ static    void    cvector_static_clear(cvector *_thiz) {
 	if (_thiz == NULL) 
 		return;
 	thiz = (cvector_data*) _thiz;
+	// pending items are dropped with the old buffer
+	thiz->migrate_end = 0;
+	cvector_migrate(thiz, 0);
+	if (cvector_unshare(thiz, 0) != 0)
+		return;
+	// slack mode restarts from the middle, room at both ends
+	if (thiz->slack)
+		thiz->first = thiz->base + (thiz->final - thiz->base) / thiz->typesize / 2 * thiz->typesize;
 	thiz->last = thiz->first;
 }
 
@@ -41,8 +665,7 @@ static    void    cvector_static_free(cvector *_thiz) {
 	if (_thiz == NULL) 
 		return;
 	thiz = (cvector_data*) _thiz;
-	if (thiz->first != NULL)
-		free(thiz->first);
+	cvector_drop(thiz);
 	free(thiz);
 }
 
@@ -117,21 +740,17 @@ static    void    cvector_static_resize(cvector *_thiz, uint64_t n, const void*
 		return;
 
 	thiz = (cvector_data*) _thiz;
-    if (thiz->first == NULL) {
-        thiz->first = malloc(n * thiz->typesize);
-        thiz->final = thiz->first + n * thiz->typesize;
+	cvector_settle(thiz, NULL);
+	if (cvector_unshare(thiz, 0) != 0)
+		return;
+    if (n * thiz->typesize > (uint64_t) (thiz->final - thiz->base)) {
+        if (cvector_buffer_replace(thiz, n * thiz->typesize, val, n) != 0)
+            return;
     } else {
-        if (n > _thiz->capacity(_thiz)) {
-            free(thiz->first);
-            thiz->first = malloc(n * thiz->typesize);
-            thiz->final  = thiz->first + n * thiz->typesize;
-        }
+        thiz->first = thiz->base;
+        cvector_range_fill(thiz->first, n, val, thiz->typesize);
     }
-
-    thiz->last = thiz->first;
-    for (uint64_t i = 0; i < n; ++i, thiz->last += thiz->typesize) {
-        memcpy(thiz->last, val, thiz->typesize);
-    }	
+    thiz->last = thiz->first + n * thiz->typesize;
 }
 
 /*   reserve: change capacity items
@@ -139,26 +758,17 @@ static    void    cvector_static_resize(cvector *_thiz, uint64_t n, const void*
  *   capacity:   max item count
  */
 static    void    cvector_static_reserve(cvector *_thiz, uint64_t capacity) {
-	void* data = NULL;
-	uint64_t max_size = 0;
 	cvector_data *thiz = NULL;
 	if ((_thiz == NULL) || (capacity <= 0))
 		return;
 	thiz = (cvector_data*) _thiz;
+	cvector_settle(thiz, NULL);
+	if (cvector_unshare(thiz, 1) != 0)
+		return;
     capacity = capacity * thiz->typesize;
-    max_size = thiz->final - thiz->first;
-    if (max_size == capacity)
+    if ((uint64_t) (thiz->final - thiz->first) == capacity)
         return;
-    data = malloc(capacity);
-    max_size = thiz->last - thiz->first;
-    if (max_size > capacity)
-        max_size = capacity;
-    if (max_size > 0)
-        memcpy(data, thiz->first, max_size);
-    free(thiz->first);
-    thiz->first = data;
-    thiz->last  = data + max_size;
-    thiz->final   = data + capacity;
+    cvector_buffer_realloc(thiz, (thiz->first - thiz->base) + capacity);
 }
 
 /*   back: last item pointer
@@ -170,9 +780,11 @@ static    void*    cvector_static_back(cvector *_thiz) {
 	if (_thiz == NULL) 
 		return NULL;
 	thiz = (cvector_data*) _thiz;
+	if (cvector_own(thiz) != 0)
+		return NULL;
 	if (thiz->first == thiz->last)
 		return NULL;
-    return (thiz->last - thiz->typesize);
+    return cvector_migrate_locate(thiz, thiz->last - thiz->typesize - thiz->first);
 }
 
 /*   front: first item pointer
@@ -184,9 +796,11 @@ static    void*    cvector_static_front(cvector *_thiz) {
 	if (_thiz == NULL) 
 		return NULL;
 	thiz = (cvector_data*) _thiz;
+	if (cvector_own(thiz) != 0)
+		return NULL;
 	if (thiz->first == thiz->last)
 		return NULL;
-	return thiz->first;
+	return cvector_migrate_locate(thiz, 0);
 }
 
 /*   at: index item pointer
@@ -201,6 +815,12 @@ static    void*    cvector_static_at(cvector *_thiz, uint64_t index) {
 	thiz = (cvector_data*) _thiz;
     if (index >= _thiz->size(_thiz))
         return NULL;
+	if (cvector_own(thiz) != 0)
+		return NULL;
+    if (thiz->pending != NULL) {
+        cvector_migrate(thiz, thiz->migrate_step);
+        return cvector_migrate_locate(thiz, index * thiz->typesize);
+    }
     return (thiz->first + index * thiz->typesize);
 }
 
@@ -213,6 +833,9 @@ static    void*    cvector_static_data(cvector *_thiz) {
 	if (_thiz == NULL) 
 		return NULL;
 	thiz = (cvector_data*) _thiz;
+	if (cvector_own(thiz) != 0)
+		return NULL;
+	cvector_settle(thiz, NULL);
 	return thiz->first;	
 }
 
@@ -225,6 +848,9 @@ static    void*    cvector_static_begin(cvector *_thiz) {
 	if (_thiz == NULL) 
 		return NULL;
 	thiz = (cvector_data*) _thiz;
+	if (cvector_own(thiz) != 0)
+		return NULL;
+	cvector_settle(thiz, NULL);
 	return thiz->first;
 }
 
@@ -237,6 +863,9 @@ static    void*    cvector_static_end(cvector *_thiz) {
 	if (_thiz == NULL) 
 		return NULL;
 	thiz = (cvector_data*) _thiz;
+	if (cvector_own(thiz) != 0)
+		return NULL;
+	cvector_settle(thiz, NULL);
 	return thiz->last;
 }
 
@@ -249,6 +878,9 @@ static    void*    cvector_static_rbegin(cvector *_thiz) {
 	if (_thiz == NULL) 
 		return NULL;
 	thiz = (cvector_data*) _thiz;
+	if (cvector_own(thiz) != 0)
+		return NULL;
+	cvector_settle(thiz, NULL);
 	if (thiz->first == thiz->last)
 		return NULL;
     return (thiz->last - thiz->typesize);
@@ -263,6 +895,9 @@ static    void*    cvector_static_rend(cvector *_thiz) {
 	if (_thiz == NULL) 
 		return NULL;
 	thiz = (cvector_data*) _thiz;
+	if (cvector_own(thiz) != 0)
+		return NULL;
+	cvector_settle(thiz, NULL);
 	if (thiz->first == thiz->last)
 		return NULL;
     return (thiz->first - thiz->typesize);
@@ -302,7 +937,15 @@ static    void    cvector_static_pop_back(cvector *_thiz) {
 	thiz = (cvector_data*) _thiz;
 	if (thiz->first == thiz->last)
 		return;
+    // the next push_back would overwrite an item snapshots still see
+    if (cvector_unshare(thiz, 1) != 0)
+        return;
     thiz->last = thiz->last - thiz->typesize;
+    // the popped item may still be pending
+    if ((thiz->pending != NULL) && ((uint64_t) (thiz->last - thiz->first) < thiz->migrate_end)) {
+        thiz->migrate_end = thiz->last - thiz->first;
+        cvector_migrate(thiz, 0);
+    }
 }
 
 /*   pop_front: delete first item 
@@ -322,19 +965,25 @@ static    void    cvector_static_pop_front(cvector *_thiz) {
  *   last: last item pointer
  */
 static    void    cvector_static_erase(cvector *_thiz, void* first, void* last) {
+	void* old = NULL;
 	cvector_data *thiz = NULL;
 	if (_thiz == NULL) 
 		return;
 	thiz = (cvector_data*) _thiz;
     if (first == NULL || last == NULL || first >= last)
         return;
+    first = cvector_migrate_rebase(thiz, first);
+    last  = cvector_settle(thiz, last);
     if (first < thiz->first)
         first = thiz->first;
     if (last > thiz->last)
         last = thiz->last;
-    for (;last < thiz->last; first = first + thiz->typesize, last = last + thiz->typesize)
-        memcpy(first, last, thiz->typesize);
-    thiz->last = first;
+    if (first >= last)
+        return;
+    old = thiz->first;
+    if (cvector_unshare(thiz, 1) != 0)
+        return;
+    cvector_range_close(thiz, thiz->first + (first - old), thiz->first + (last - old));
 }
 
 /*   remove: delete position item 
@@ -362,21 +1011,21 @@ static    void    cvector_static_assign(cvector *_thiz, void* first, void* last)
 	thiz = (cvector_data*) _thiz;
     if (first == NULL || last == NULL || first >= last)
         return;
+    first = cvector_migrate_rebase(thiz, first);
+    last  = cvector_settle(thiz, last);
+    // first..last may be in the shared buffer, still alive for the snapshots
+    if (cvector_unshare(thiz, 0) != 0)
+        return;
     size = (last - first);
 
-    if (thiz->first == NULL) {
-        thiz->first = malloc(size);
-        thiz->final  = thiz->first + size;
+    if (size > (uint64_t) (thiz->final - thiz->base)) {
+        if (cvector_buffer_replace(thiz, size, first, 0) != 0)
+            return;
     } else {
-        if (size > (thiz->final - thiz->first)) {
-            free(thiz->first);
-            thiz->first = malloc(size);
-            thiz->final  = thiz->first + size;
-        }
+        memmove(thiz->base, first, size);
+        thiz->first = thiz->base;
     }
-
     thiz->last = thiz->first + size;
-    memcpy(thiz->first, first, size);
 }
 
 /*   fill: copy value  n * typesize val from position begin
@@ -386,40 +1035,32 @@ static    void    cvector_static_assign(cvector *_thiz, void* first, void* last)
  *   val:  item pointer
  */
 static    void    cvector_static_fill(cvector *_thiz, void* position, uint64_t n, const void* val) {
-	uint64_t newsize, size, capacity, step = 0;
-	void* ptr = NULL;
+	uint8_t buf[64];
+	void* tmp = NULL;
 	cvector_data *thiz = NULL;
 	if ((_thiz == NULL) || (val == NULL) || (n <= 0) || (position == NULL))
 		return;
 	thiz = (cvector_data*) _thiz;
-    
-    newsize  = n * thiz->typesize;
-    size     = thiz->last - thiz->first;
-    capacity = thiz->final  - thiz->first;
-
-    if (newsize + size > capacity) {
-        uint64_t pos = position - thiz->first;
-        ptr = malloc(2 * (newsize + size));
-        if (pos > 0)
-            memcpy(ptr, thiz->first, pos);
-        for (step = 0; step < newsize; step = step + thiz->typesize)
-            memcpy(ptr + pos + step, val, thiz->typesize);
-        if (size > pos)
-            memcpy(ptr + pos + newsize, position, size - pos);
-        free(thiz->first);
-        thiz->first = ptr;
-        thiz->last  = ptr + newsize + size;
-        thiz->final   = ptr + 2 * (newsize + size);
+    // range_open moves pending items unless this is an append
+    if (position != thiz->last)
+        position = cvector_migrate_rebase(thiz, position);
+    if (position < thiz->first || position > thiz->last)
         return;
-    }
-    ptr = thiz->last - thiz->typesize;
-    for ( ;ptr >= position; ptr = ptr - thiz->typesize) {
-        memcpy(ptr + newsize, ptr, thiz->typesize);
+
+    // val may live in the tail that is about to move
+    if (cvector_range_within(thiz, val)) {
+        tmp = (thiz->typesize <= sizeof(buf)) ? buf : malloc(thiz->typesize);
+        if (tmp == NULL)
+            return;
+        memcpy(tmp, val, thiz->typesize);
+        val = tmp;
     }
 
-    for (step = 0; step < newsize; step = step + thiz->typesize)
-        memcpy(position + step, val, thiz->typesize);
-    thiz->last = thiz->last + newsize;
+    position = cvector_range_open(thiz, position, n * thiz->typesize);
+    if (position != NULL)
+        cvector_range_fill(position, n, val, thiz->typesize);
+    if ((tmp != NULL) && (tmp != buf))
+        free(tmp);
 }
 
 /*   insert: insert values from first to last items  at position
@@ -429,64 +1070,178 @@ static    void    cvector_static_fill(cvector *_thiz, void* position, uint64_t n
  *   last: last item pointer
  */
 static    void    cvector_static_insert(cvector *_thiz, void* position, void* first, void* last) {
-	uint64_t newsize, size, capacity;
-	void* ptr = NULL;
+	uint64_t newsize;
+	void* tmp = NULL;
 	cvector_data *thiz = NULL;
 	if (_thiz == NULL) 
 		return;
 	thiz = (cvector_data*) _thiz;
     if (position == NULL || first == NULL || last == NULL)
         return;
+    if (position != thiz->last)
+        position = cvector_migrate_rebase(thiz, position);
     if (position < thiz->first || position > thiz->last || first >= last)
         return;
-    
-    newsize  = last - first;
-    size     = thiz->last - thiz->first;
-    capacity = thiz->final  - thiz->first;
-
-    if (newsize + size > capacity) {
-        uint64_t pos = position - thiz->first;
-        ptr = malloc(2 * (newsize + size));
-        if (pos > 0)
-            memcpy(ptr, thiz->first, pos);
-        memcpy(ptr + pos, first, newsize);
-        if (size > pos)
-            memcpy(ptr + pos + newsize, position, size - pos);
-        free(thiz->first);
-        thiz->first = ptr;
-        thiz->last  = ptr + newsize + size;
-        thiz->final   = ptr + 2 * (newsize + size);
-        return;
+
+    // source range may span both buffers while migrating, move every item first
+    if ((thiz->pending != NULL) && (cvector_range_within(thiz, first) || cvector_range_within(thiz, last - 1))) {
+        first = cvector_migrate_rebase(thiz, first);
+        last  = cvector_settle(thiz, last);
     }
-    ptr = thiz->last - thiz->typesize;
-    for ( ;ptr >= position; ptr = ptr - thiz->typesize) {
-        memcpy(ptr + newsize, ptr, thiz->typesize);
+    newsize = last - first;
+    // source range may live in the tail that is about to move
+    if (cvector_range_within(thiz, first) || cvector_range_within(thiz, last - 1)) {
+        tmp = malloc(newsize);
+        if (tmp == NULL)
+            return;
+        memcpy(tmp, first, newsize);
+        first = tmp;
     }
-    memcpy(position, first, newsize);
-    thiz->last = thiz->last + newsize;
+
+    position = cvector_range_open(thiz, position, newsize);
+    if (position != NULL)
+        memcpy(position, first, newsize);
+    if (tmp != NULL)
+        free(tmp);
 }
 
 /*   reverse: first and last items change 
  *   thiz: cvector pointer
  */
 static    void    cvector_static_reverse(cvector *_thiz) {
-	void *first, *last, *val;
 	cvector_data *thiz = NULL;
 	if (_thiz == NULL) 
 		return;
 	thiz = (cvector_data*) _thiz;
-    if (thiz->first == thiz->last)
-        return;
+	cvector_settle(thiz, NULL);
+	if (cvector_unshare(thiz, 1) != 0)
+		return;
+    cvector_algo_reverse(thiz->first, (thiz->last - thiz->first) / thiz->typesize, thiz->typesize);
+}
 
-    first = thiz->first;
-    last = thiz->last - thiz->typesize;
-    val  = malloc(thiz->typesize);
-    for (; first < last; first = first + thiz->typesize, last = last - thiz->typesize) {
-        memcpy(val,   first, thiz->typesize);
-        memcpy(first, last,  thiz->typesize);
-        memcpy(last,  val,   thiz->typesize);
-    }
-    free(val);
+/*   rotate: rotate items left, middle item becomes the first
+ *   thiz: cvector pointer
+ *   middle: item pointer, first to last
+ */
+static    void    cvector_static_rotate(cvector *_thiz, void* middle) {
+	uint64_t pos;
+	cvector_data *thiz = NULL;
+	if ((_thiz == NULL) || (middle == NULL))
+		return;
+	thiz = (cvector_data*) _thiz;
+	middle = cvector_settle(thiz, middle);
+	// first or last leave the items as they are
+	if ((middle <= thiz->first) || (middle >= thiz->last))
+		return;
+	pos = middle - thiz->first;
+	if (cvector_unshare(thiz, 1) != 0)
+		return;
+	cvector_algo_rotate(thiz->first, (thiz->last - thiz->first) / thiz->typesize, thiz->typesize, pos / thiz->typesize);
+}
+
+// fixed typesize functions, N is a constant so copies become plain loads and stores
+#define CVECTOR_TYPED(N)                                                                       \
+static uint64_t    cvector_static_size_##N(cvector *_thiz) {                                   \
+	cvector_data *thiz = NULL;                                                                 \
+	if (_thiz == NULL)                                                                         \
+		return 0;                                                                              \
+	thiz = (cvector_data*) _thiz;                                                              \
+	return (thiz->last - thiz->first) / N;                                                     \
+}                                                                                              \
+                                                                                               \
+static    void*    cvector_static_at_##N(cvector *_thiz, uint64_t index) {                     \
+	cvector_data *thiz = NULL;                                                                 \
+	if (_thiz == NULL)                                                                         \
+		return NULL;                                                                           \
+	thiz = (cvector_data*) _thiz;                                                              \
+	if (index >= (uint64_t) (thiz->last - thiz->first) / N)                                    \
+		return NULL;                                                                           \
+	if (cvector_own(thiz) != 0)                                                                \
+		return NULL;                                                                           \
+	return (thiz->first + index * N);                                                          \
+}                                                                                              \
+                                                                                               \
+static    void    cvector_static_fill_##N(cvector *_thiz, void* position, uint64_t n, const void* val) { \
+	uint8_t item[N];                                                                           \
+	uint64_t i;                                                                                \
+	cvector_data *thiz = NULL;                                                                 \
+	if ((_thiz == NULL) || (val == NULL) || (n <= 0) || (position == NULL))                    \
+		return;                                                                                \
+	thiz = (cvector_data*) _thiz;                                                              \
+	if (position < thiz->first || position > thiz->last)                                       \
+		return;                                                                                \
+	memcpy(item, val, N);                                                                      \
+	position = cvector_range_open(thiz, position, n * N);                                      \
+	if (position == NULL)                                                                      \
+		return;                                                                                \
+	for (i = 0; i < n; ++i)                                                                    \
+		memcpy(position + i * N, item, N);                                                     \
+}                                                                                              \
+                                                                                               \
+static    void    cvector_static_push_back_##N(cvector *_thiz, const void* val) {              \
+	cvector_data *thiz = NULL;                                                                 \
+	if ((_thiz == NULL) || (val == NULL))                                                      \
+		return;                                                                                \
+	thiz = (cvector_data*) _thiz;                                                              \
+	if (thiz->last + N <= thiz->final) {                                                       \
+		memcpy(thiz->last, val, N);                                                            \
+		thiz->last = thiz->last + N;                                                           \
+		return;                                                                                \
+	}                                                                                          \
+	cvector_static_fill_##N(_thiz, thiz->last, 1, val);                                        \
+}
+
+CVECTOR_TYPED(1)
+CVECTOR_TYPED(2)
+CVECTOR_TYPED(4)
+CVECTOR_TYPED(8)
+CVECTOR_TYPED(16)
+CVECTOR_TYPED(32)
+
+struct cvector_typed_t {
+    uint64_t     typesize;
+    uint64_t     (*size)(cvector *thiz);
+    void*        (*at)(cvector *thiz, uint64_t index);
+    void         (*fill)(cvector *thiz, void* position, uint64_t n, const void* val);
+    void         (*push_back)(cvector *thiz, const void* val);
+};
+
+typedef struct cvector_typed_t  cvector_typed;
+
+#define CVECTOR_TYPED_ENTRY(N)  {N, cvector_static_size_##N, cvector_static_at_##N, \
+	cvector_static_fill_##N, cvector_static_push_back_##N}
+
+static const cvector_typed cvector_typed_table[] = {
+	CVECTOR_TYPED_ENTRY(1),
+	CVECTOR_TYPED_ENTRY(2),
+	CVECTOR_TYPED_ENTRY(4),
+	CVECTOR_TYPED_ENTRY(8),
+	CVECTOR_TYPED_ENTRY(16),
+	CVECTOR_TYPED_ENTRY(32),
+};
+
+/*   install_typed: install typesize functions, generic ones for other typesize
+ *   thiz: cvector pointer
+ *   typesize: item size
+ */
+static    void    cvector_install_typed(cvector *thiz, uint64_t typesize) {
+	uint64_t i;
+	thiz->size       = cvector_static_size;
+	thiz->at         = cvector_static_at;
+	thiz->fill       = cvector_static_fill;
+	thiz->push_back  = cvector_static_push_back;
+	// typed push_back skips the migration step
+	if (((cvector_data*) thiz)->migrate_step > 0)
+		return;
+	for (i = 0; i < sizeof(cvector_typed_table) / sizeof(cvector_typed_table[0]); ++i) {
+		if (cvector_typed_table[i].typesize != typesize)
+			continue;
+		thiz->size       = cvector_typed_table[i].size;
+		thiz->at         = cvector_typed_table[i].at;
+		thiz->fill       = cvector_typed_table[i].fill;
+		thiz->push_back  = cvector_typed_table[i].push_back;
+		return;
+	}
 }
 
 /*   copy: copy value from thiz to that
@@ -499,8 +1254,13 @@ static    void    cvector_static_copy(cvector *_thiz, cvector *_that) {
 		return;
 	}
 	thiz = (cvector_data*) _thiz;
+	cvector_settle(thiz, NULL);
 	that = (cvector_data*) _that;
+	if (that->readonly)
+		return;
 	_that->assign(_that, thiz->first, thiz->last);
+	if (that->typesize != thiz->typesize)
+		cvector_install_typed(_that, thiz->typesize);
 	that->typesize = thiz->typesize;
 }
 
@@ -519,6 +1279,8 @@ static    uint8_t    cvector_static_equal(cvector *_thiz, cvector *_that) {
 	if (thiz->typesize != that->typesize) {
 		return 0;
 	}
+	cvector_settle(thiz, NULL);
+	cvector_settle(that, NULL);
 
 	if ((thiz->first == NULL) || (that->first == NULL)) {
 		return 0;
@@ -534,32 +1296,451 @@ static    uint8_t    cvector_static_equal(cvector *_thiz, cvector *_that) {
     return 1;	
 }
 
-/*   cvector_alloc: malloc cvector pointer
+/*   swap: exchange the items of thiz and that, buffers change owner, no item is copied
+ *   thiz: cvector pointer
+ *   that: cvector pointer
+ */
+static    void    cvector_static_swap(cvector *_thiz, cvector *_that) {
+	cvector_data *thiz = NULL, *that = NULL, tmp;
+	if ((_thiz == NULL) || (_that == NULL) || (_thiz == _that)) {
+		return;
+	}
+	thiz = (cvector_data*) _thiz;
+	that = (cvector_data*) _that;
+	if (thiz->readonly || that->readonly)
+		return;
+	if ((cvector_detach(thiz) != 0) || (cvector_detach(that) != 0))
+		return;
+
+	memcpy(&tmp, thiz, sizeof(cvector_data));
+	thiz->first    = that->first;
+	thiz->last     = that->last;
+	thiz->final    = that->final;
+	thiz->base     = that->base;
+	thiz->storage  = that->storage;
+	thiz->share    = that->share;
+	thiz->typesize = that->typesize;
+	that->first    = tmp.first;
+	that->last     = tmp.last;
+	that->final    = tmp.final;
+	that->base     = tmp.base;
+	that->storage  = tmp.storage;
+	that->share    = tmp.share;
+	that->typesize = tmp.typesize;
+	if (thiz->typesize != that->typesize) {
+		cvector_install_typed(_thiz, thiz->typesize);
+		cvector_install_typed(_that, that->typesize);
+	}
+}
+
+/*   move_into: free the items of thiz and take the buffer of that, that becomes empty
+ *   thiz: cvector pointer
+ *   that: cvector pointer
+ */
+static    void    cvector_static_move_into(cvector *_thiz, cvector *_that) {
+	cvector_data *thiz = NULL, *that = NULL, tmp;
+	if ((_thiz == NULL) || (_that == NULL) || (_thiz == _that)) {
+		return;
+	}
+	thiz = (cvector_data*) _thiz;
+	that = (cvector_data*) _that;
+	if (thiz->readonly || that->readonly)
+		return;
+	if (cvector_detach(that) != 0)
+		return;
+
+	memcpy(&tmp, that, sizeof(cvector_data));
+	if (cvector_empty_buffer(that) != 0)
+		return;
+	cvector_drop(thiz);
+	thiz->first   = tmp.first;
+	thiz->last    = tmp.last;
+	thiz->final   = tmp.final;
+	thiz->base    = tmp.base;
+	thiz->storage = tmp.storage;
+	thiz->share   = tmp.share;
+	if (thiz->typesize != tmp.typesize)
+		cvector_install_typed(_thiz, tmp.typesize);
+	thiz->typesize = tmp.typesize;
+}
+
+/*   emplace_back: add one uninitialized last item
+ *   thiz: cvector pointer
+ *   return new item pointer, NULL if out of memory
+ */
+static    void*    cvector_static_emplace_back(cvector *_thiz) {
+	cvector_data *thiz = NULL;
+	if (_thiz == NULL) 
+		return NULL;
+	thiz = (cvector_data*) _thiz;
+	return cvector_range_open(thiz, thiz->last, thiz->typesize);
+}
+
+/*   push_back_n: add n items behind, copied from src
+ *   thiz: cvector pointer
+ *   src:  first item pointer
+ *   n:    item count
+ */
+static    void    cvector_static_push_back_n(cvector *_thiz, const void* src, uint64_t n) {
+	uint64_t offset = 0, size;
+	uint8_t within;
+	void *ptr = NULL, *old = NULL;
+	cvector_data *thiz = NULL;
+	if ((_thiz == NULL) || (src == NULL) || (n <= 0))
+		return;
+	thiz = (cvector_data*) _thiz;
+    size   = n * thiz->typesize;
+    // src items may span both buffers while migrating, move every item first
+    if ((thiz->pending != NULL) && cvector_range_within(thiz, src))
+        src = cvector_settle(thiz, (void*) src);
+    // nothing moves behind last, src only needs rebasing if the buffer moves
+    within = cvector_range_within(thiz, src);
+    if (within) {
+        offset = src - thiz->first;
+        old    = thiz->first;
+    }
+    ptr = cvector_range_open(thiz, thiz->last, size);
+    if (ptr == NULL)
+        return;
+    // incremental growth keeps the old buffer as pending, src items still there
+    if (within)
+        src = ((old != NULL) && (thiz->pending == old)) ? (old + offset) : (thiz->first + offset);
+    memcpy(ptr, src, size);
+}
+
+/*   append_uninitialized: add n uninitialized last items
+ *   thiz: cvector pointer
+ *   n:    item count
+ *   return first new item pointer, NULL if out of memory
+ */
+static    void*    cvector_static_append_uninitialized(cvector *_thiz, uint64_t n) {
+	cvector_data *thiz = NULL;
+	if ((_thiz == NULL) || (n <= 0))
+		return NULL;
+	thiz = (cvector_data*) _thiz;
+	return cvector_range_open(thiz, thiz->last, n * thiz->typesize);
+}
+
+/*   find: first item equal val
+ *   thiz: cvector pointer
+ *   val:  item pointer
+ *   return item pointer, NULL if not found
+ */
+static    void*    cvector_static_find(cvector *_thiz, const void* val) {
+	cvector_data *thiz = NULL;
+	if (_thiz == NULL) 
+		return NULL;
+	thiz = (cvector_data*) _thiz;
+	cvector_settle(thiz, NULL);
+	return cvector_algo_find(thiz->first, (thiz->last - thiz->first) / thiz->typesize, thiz->typesize, val);
+}
+
+/*   rfind: last item equal val
+ *   thiz: cvector pointer
+ *   val:  item pointer
+ *   return item pointer, NULL if not found
+ */
+static    void*    cvector_static_rfind(cvector *_thiz, const void* val) {
+	cvector_data *thiz = NULL;
+	if (_thiz == NULL) 
+		return NULL;
+	thiz = (cvector_data*) _thiz;
+	cvector_settle(thiz, NULL);
+	return cvector_algo_rfind(thiz->first, (thiz->last - thiz->first) / thiz->typesize, thiz->typesize, val);
+}
+
+/*   count: count items equal val
+ *   thiz: cvector pointer
+ *   val:  item pointer
+ *   return item count equal val
+ */
+static    uint64_t    cvector_static_count(cvector *_thiz, const void* val) {
+	cvector_data *thiz = NULL;
+	if (_thiz == NULL) 
+		return 0;
+	thiz = (cvector_data*) _thiz;
+	cvector_settle(thiz, NULL);
+	return cvector_algo_count(thiz->first, (thiz->last - thiz->first) / thiz->typesize, thiz->typesize, val);
+}
+
+/*   find_if: first item pred returns non zero
+ *   thiz: cvector pointer
+ *   pred: pred(item, arg)
+ *   arg:  pred user pointer
+ *   return item pointer, NULL if not found
+ */
+static    void*    cvector_static_find_if(cvector *_thiz, uint8_t (*pred)(const void* item, void* arg), void* arg) {
+	cvector_data *thiz = NULL;
+	if (_thiz == NULL) 
+		return NULL;
+	thiz = (cvector_data*) _thiz;
+	cvector_settle(thiz, NULL);
+	return cvector_algo_find_if(thiz->first, (thiz->last - thiz->first) / thiz->typesize, thiz->typesize, pred, arg);
+}
+
+/*   sort: sort items in place, not stable
+ *   thiz: cvector pointer
+ *   cmp:  cmp(a, b) < 0, == 0, > 0 as qsort
+ */
+static    void    cvector_static_sort(cvector *_thiz, int (*cmp)(const void* a, const void* b)) {
+	cvector_data *thiz = NULL;
+	if (_thiz == NULL) 
+		return;
+	thiz = (cvector_data*) _thiz;
+	cvector_settle(thiz, NULL);
+	if (cvector_unshare(thiz, 1) != 0)
+		return;
+	cvector_algo_sort(thiz->first, (thiz->last - thiz->first) / thiz->typesize, thiz->typesize, cmp);
+}
+
+/*   radix_sort: sort items by an unsigned integer key in linear time, stable
+ *   thiz: cvector pointer
+ *   key_offset: key byte offset in item
+ *   key_width:  key size, 1, 2, 4 or 8, native byte order
+ *   return 0 if success, -1 if bad key or out of memory
+ */
+static    int    cvector_static_radix_sort(cvector *_thiz, uint64_t key_offset, uint64_t key_width) {
+	cvector_data *thiz = NULL;
+	if (_thiz == NULL) 
+		return -1;
+	thiz = (cvector_data*) _thiz;
+	cvector_settle(thiz, NULL);
+	if (cvector_unshare(thiz, 1) != 0)
+		return -1;
+	return cvector_algo_radix_sort(thiz->first, (thiz->last - thiz->first) / thiz->typesize, thiz->typesize, key_offset, key_width);
+}
+
+/*   parallel_sort: sort items in place with threads, not stable
+ *   thiz: cvector pointer
+ *   cmp:  cmp(a, b) < 0, == 0, > 0 as qsort
+ *   threads: thread count, 0 for online cpu count
+ */
+static    void    cvector_static_parallel_sort(cvector *_thiz, int (*cmp)(const void* a, const void* b), uint64_t threads) {
+	cvector_data *thiz = NULL;
+	if (_thiz == NULL) 
+		return;
+	thiz = (cvector_data*) _thiz;
+	cvector_settle(thiz, NULL);
+	if (cvector_unshare(thiz, 1) != 0)
+		return;
+	// out of memory for the merge buffer, sort on this thread
+	if (cvector_algo_parallel_sort(thiz->first, (thiz->last - thiz->first) / thiz->typesize, thiz->typesize, cmp, threads) != 0)
+		cvector_algo_sort(thiz->first, (thiz->last - thiz->first) / thiz->typesize, thiz->typesize, cmp);
+}
+
+/*   lower_bound: first item not less than val, items sorted by cmp
+ *   thiz: cvector pointer
+ *   val:  item pointer
+ *   cmp:  cmp(item, val) < 0, == 0, > 0 as qsort
+ *   return item pointer, end() if every item is less
+ */
+static    void*    cvector_static_lower_bound(cvector *_thiz, const void* val, int (*cmp)(const void* a, const void* b)) {
+	cvector_data *thiz = NULL;
+	if (_thiz == NULL) 
+		return NULL;
+	thiz = (cvector_data*) _thiz;
+	cvector_settle(thiz, NULL);
+	return cvector_algo_lower_bound(thiz->first, (thiz->last - thiz->first) / thiz->typesize, thiz->typesize, val, cmp);
+}
+
+/*   upper_bound: first item greater than val, items sorted by cmp
+ *   thiz: cvector pointer
+ *   val:  item pointer
+ *   cmp:  cmp(item, val) < 0, == 0, > 0 as qsort
+ *   return item pointer, end() if no item is greater
+ */
+static    void*    cvector_static_upper_bound(cvector *_thiz, const void* val, int (*cmp)(const void* a, const void* b)) {
+	cvector_data *thiz = NULL;
+	if (_thiz == NULL) 
+		return NULL;
+	thiz = (cvector_data*) _thiz;
+	cvector_settle(thiz, NULL);
+	return cvector_algo_upper_bound(thiz->first, (thiz->last - thiz->first) / thiz->typesize, thiz->typesize, val, cmp);
+}
+
+/*   equal_range: items equal val, items sorted by cmp
+ *   thiz: cvector pointer
+ *   val:  item pointer
+ *   cmp:  cmp(item, val) < 0, == 0, > 0 as qsort
+ *   first: set to lower_bound
+ *   last:  set to upper_bound
+ */
+static    void    cvector_static_equal_range(cvector *_thiz, const void* val, int (*cmp)(const void* a, const void* b),
+                                               void** first, void** last) {
+	cvector_data *thiz = NULL;
+	if ((_thiz == NULL) || (first == NULL) || (last == NULL))
+		return;
+	thiz = (cvector_data*) _thiz;
+	cvector_settle(thiz, NULL);
+	*first = cvector_algo_lower_bound(thiz->first, (thiz->last - thiz->first) / thiz->typesize, thiz->typesize, val, cmp);
+	*last  = NULL;
+	// upper bound lies at or behind lower bound
+	if (*first != NULL)
+		*last = cvector_algo_upper_bound(*first, (thiz->last - *first) / thiz->typesize, thiz->typesize, val, cmp);
+}
+
+/*   sorted_insert: insert val behind its equal items, items sorted by cmp
+ *   thiz: cvector pointer
+ *   val:  item pointer
+ *   cmp:  cmp(item, val) < 0, == 0, > 0 as qsort
+ *   return inserted item pointer, NULL if out of memory
+ */
+static    void*    cvector_static_sorted_insert(cvector *_thiz, const void* val, int (*cmp)(const void* a, const void* b)) {
+	uint64_t pos, used;
+	void* position = NULL;
+	cvector_data *thiz = NULL;
+	if ((_thiz == NULL) || (val == NULL) || (cmp == NULL))
+		return NULL;
+	thiz = (cvector_data*) _thiz;
+	cvector_settle(thiz, NULL);
+	position = cvector_algo_upper_bound(thiz->first, (thiz->last - thiz->first) / thiz->typesize, thiz->typesize, val, cmp);
+	if (position == NULL)
+		return NULL;
+	pos  = position - thiz->first;
+	used = thiz->last - thiz->first;
+	_thiz->fill(_thiz, position, 1, val);
+	if ((uint64_t) (thiz->last - thiz->first) == used)
+		return NULL;
+	return thiz->first + pos;
+}
+
+/*   span: view of the items from first to last
+ *   thiz: cvector pointer
+ *   first: begin item pointer
+ *   last: end item pointer, not in the span
+ *   return span, empty if the range is not in thiz
+ */
+static    cvector_span    cvector_static_span(cvector *_thiz, void* first, void* last) {
+	cvector_data *thiz = NULL;
+	if ((_thiz == NULL) || (first == NULL) || (last == NULL))
+		return cvector_span_make(NULL, 0, 0);
+	thiz = (cvector_data*) _thiz;
+	// a span has one base, pending items move to the new buffer first
+	first = cvector_migrate_rebase(thiz, first);
+	last  = cvector_settle(thiz, last);
+	if ((first < thiz->first) || (last > thiz->last) || (first >= last))
+		return cvector_span_make(NULL, 0, thiz->typesize);
+	return cvector_span_make(first, (last - first) / thiz->typesize, thiz->typesize);
+}
+
+static    cvector*    cvector_install(cvector_data *thiz_data);
+
+/*   snapshot: read only view of the items, shares the buffer until thiz changes
+ *   thiz: cvector pointer
+ *   return cvector pointer, free it with free, NULL if out of memory
+ */
+static    cvector*    cvector_static_snapshot(cvector *_thiz) {
+	cvector_data *thiz = NULL, *snap = NULL;
+	cvector_share *share = NULL;
+	cvector *copy = NULL, *view = NULL;
+	if (_thiz == NULL)
+		return NULL;
+	thiz = (cvector_data*) _thiz;
+	cvector_settle(thiz, NULL);
+
+	// inline items live in the cvector allocation, snapshot a heap copy of them
+	if (thiz->storage == CVECTOR_BUFFER_INLINE) {
+		copy = cvector_alloc((thiz->last > thiz->first) ? (thiz->last - thiz->first) / thiz->typesize : 1, thiz->typesize);
+		if (copy == NULL)
+			return NULL;
+		_thiz->copy(_thiz, copy);
+		view = cvector_static_snapshot(copy);
+		copy->free(copy);
+		return view;
+	}
+
+	if (thiz->share == NULL) {
+		share = (cvector_share*) malloc(sizeof(cvector_share));
+		if (share == NULL)
+			return NULL;
+		atomic_init(&share->refs, 1);
+		share->base    = thiz->base;
+		share->size    = thiz->final - thiz->base;
+		share->storage = thiz->storage;
+		thiz->share    = share;
+	}
+	snap = (cvector_data*) malloc(sizeof(cvector_data));
+	if (snap == NULL)
+		return NULL;
+	atomic_fetch_add_explicit(&thiz->share->refs, 1, memory_order_relaxed);
+	memcpy(snap, thiz, sizeof(cvector_data));
+	// no room behind last, appends go through unshare and are refused
+	snap->final        = snap->last;
+	snap->readonly     = 1;
+	snap->migrate_step = 0;
+	return cvector_install(snap);
+}
+
+/*   alloc_data: malloc cvector data and its buffer
  *   size:     cvector item count
  *   typesize: cvector item size
- *   return: cvector pointer
+ *   growth:   growth policy
+ *   step:     growth policy step
+ *   inline_size: inline buffer bytes, 0 for none
+ *   slack:    1 keeps free items before first too
+ *   migrate:  item count moved per call after incremental growth, 0 copies at once
+ *   return: cvector data pointer
  */
-cvector* cvector_alloc(uint64_t size, uint64_t typesize) {
-	cvector *thiz = NULL;
+static    cvector_data*    cvector_alloc_data(uint64_t size, uint64_t typesize, uint64_t growth, uint64_t step, uint64_t inline_size,
+                                              uint8_t slack, uint64_t migrate) {
 	cvector_data *thiz_data = NULL;
 	if ((size <= 0) || (typesize <= 0)) {
 		return NULL;
 	}
+	if ((growth > CVECTOR_GROWTH_EXACT) || ((growth != CVECTOR_GROWTH_EXACT) && (step <= 0))) {
+		return NULL;
+	}
+	// a factor of 100 percent or less never grows the buffer
+	if ((growth == CVECTOR_GROWTH_FACTOR) && (step <= 100)) {
+		return NULL;
+	}
 
-	thiz_data = (cvector_data *)malloc(sizeof(cvector_data));
+	thiz_data = (cvector_data *)malloc((inline_size > 0) ? (CVECTOR_INLINE_OFFSET + inline_size) : sizeof(cvector_data));
 	if (thiz_data == NULL) {
 		return NULL;
 	}
 
-	thiz_data->first = malloc(size * typesize);
-	if (thiz_data->first == NULL) {
-		free(thiz_data);
-		return NULL;
+	thiz_data->inline_size = inline_size;
+	if (size * typesize <= inline_size) {
+		thiz_data->storage = CVECTOR_BUFFER_INLINE;
+		thiz_data->base    = (uint8_t*) thiz_data + CVECTOR_INLINE_OFFSET;
+		size = inline_size / typesize;
+	} else {
+		thiz_data->base = cvector_buffer_alloc(size * typesize, &(thiz_data->storage));
+		if (thiz_data->base == NULL) {
+			free(thiz_data);
+			return NULL;
+		}
 	}
 
+    thiz_data->growth   = growth;
+    thiz_data->step     = step;
     thiz_data->typesize = typesize;
+    thiz_data->slack    = slack;
+    thiz_data->pending      = NULL;
+    thiz_data->pending_size = 0;
+    thiz_data->pending_offset = 0;
+    thiz_data->migrated     = 0;
+    thiz_data->migrate_end  = 0;
+    thiz_data->migrate_step = migrate * typesize;
+    thiz_data->share        = NULL;
+    thiz_data->readonly     = 0;
+    // slack mode starts from the middle
+    thiz_data->first  = thiz_data->base + (slack ? size / 2 * typesize : 0);
     thiz_data->last = thiz_data->first;
-    thiz_data->final  = thiz_data->first + size * typesize;
+    thiz_data->final  = thiz_data->base + size * typesize;
+    return thiz_data;
+}
+
+/*   install: install cvector functions
+ *   thiz_data: cvector data pointer
+ *   return: cvector pointer
+ */
+static    cvector*    cvector_install(cvector_data *thiz_data) {
+	cvector *thiz = NULL;
+	if (thiz_data == NULL) {
+		return NULL;
+	}
 
 	thiz = (cvector*) &(thiz_data->vector);
 
@@ -589,8 +1770,151 @@ cvector* cvector_alloc(uint64_t size, uint64_t typesize) {
 	thiz->fill  = cvector_static_fill;
 	thiz->insert  = cvector_static_insert;
 	thiz->reverse  = cvector_static_reverse;
+	thiz->rotate  = cvector_static_rotate;
 	thiz->copy  = cvector_static_copy;
 	thiz->equal  = cvector_static_equal;
+	thiz->swap  = cvector_static_swap;
+	thiz->move_into  = cvector_static_move_into;
+	thiz->emplace_back  = cvector_static_emplace_back;
+	thiz->push_back_n  = cvector_static_push_back_n;
+	thiz->append_uninitialized  = cvector_static_append_uninitialized;
+	thiz->find  = cvector_static_find;
+	thiz->rfind  = cvector_static_rfind;
+	thiz->count  = cvector_static_count;
+	thiz->find_if  = cvector_static_find_if;
+	thiz->sort  = cvector_static_sort;
+	thiz->radix_sort  = cvector_static_radix_sort;
+	thiz->parallel_sort  = cvector_static_parallel_sort;
+	thiz->lower_bound  = cvector_static_lower_bound;
+	thiz->upper_bound  = cvector_static_upper_bound;
+	thiz->equal_range  = cvector_static_equal_range;
+	thiz->sorted_insert  = cvector_static_sorted_insert;
+	thiz->snapshot  = cvector_static_snapshot;
+	thiz->span  = cvector_static_span;
+	cvector_install_typed(thiz, thiz_data->typesize);
 
     return thiz;
 }
+
+/*   cvector_alloc: malloc cvector pointer
+ *   size:     cvector item count
+ *   typesize: cvector item size
+ *   return: cvector pointer
+ */
+cvector* cvector_alloc(uint64_t size, uint64_t typesize) {
+	return cvector_alloc_growth(size, typesize, CVECTOR_GROWTH_FACTOR, 200);
+}
+
+/*   cvector_alloc_inline: malloc cvector pointer, the first items live inline
+ *   size:     cvector item count
+ *   typesize: cvector item size
+ *   inline_count: inline item count, spills to the heap when exceeded
+ *   return: cvector pointer
+ */
+cvector* cvector_alloc_inline(uint64_t size, uint64_t typesize, uint64_t inline_count) {
+	return cvector_install(cvector_alloc_data(size, typesize, CVECTOR_GROWTH_FACTOR, 200, inline_count * typesize, 0, 0));
+}
+
+/*   cvector_alloc_growth: malloc cvector pointer with growth policy
+ *   size:     cvector item count
+ *   typesize: cvector item size
+ *   growth:   CVECTOR_GROWTH_FACTOR, CVECTOR_GROWTH_STEP or CVECTOR_GROWTH_EXACT
+ *   step:     factor in percent, or step item count
+ *   return: cvector pointer
+ */
+cvector* cvector_alloc_growth(uint64_t size, uint64_t typesize, uint64_t growth, uint64_t step) {
+	return cvector_install(cvector_alloc_data(size, typesize, growth, step, 0, 0, 0));
+}
+
+/*   cvector_alloc_slack: malloc cvector pointer, free items kept before first and behind last
+ *   size:     cvector item count
+ *   typesize: cvector item size
+ *   return: cvector pointer
+ */
+cvector* cvector_alloc_slack(uint64_t size, uint64_t typesize) {
+	return cvector_install(cvector_alloc_data(size, typesize, CVECTOR_GROWTH_FACTOR, 200, 0, 1, 0));
+}
+
+/*   cvector_alloc_incremental: malloc cvector pointer, growth copies items a few per call
+ *   size:     cvector item count
+ *   typesize: cvector item size
+ *   migrate:  item count moved from the old buffer per push_back, emplace_back, at call
+ *   return: cvector pointer
+ */
+cvector* cvector_alloc_incremental(uint64_t size, uint64_t typesize, uint64_t migrate) {
+	if (migrate <= 0)
+		return NULL;
+	return cvector_install(cvector_alloc_data(size, typesize, CVECTOR_GROWTH_FACTOR, 200, 0, 0, migrate));
+}
+
+/*   cvector_adopt: wrap a malloc buffer in a cvector, no item is copied
+ *   ptr:      buffer from malloc, freed by the cvector
+ *   count:    item count in ptr
+ *   capacity: item count ptr holds, >= count
+ *   typesize: cvector item size
+ *   return: cvector pointer, NULL if the arguments are bad or out of memory, ptr is not freed then
+ */
+cvector* cvector_adopt(void* ptr, uint64_t count, uint64_t capacity, uint64_t typesize) {
+	cvector_data *thiz_data = NULL;
+	if ((ptr == NULL) || (typesize <= 0) || (capacity <= 0) || (count > capacity)) {
+		return NULL;
+	}
+
+	thiz_data = (cvector_data *)malloc(sizeof(cvector_data));
+	if (thiz_data == NULL) {
+		return NULL;
+	}
+
+    thiz_data->inline_size = 0;
+    thiz_data->storage  = CVECTOR_BUFFER_HEAP;
+    thiz_data->base     = ptr;
+    thiz_data->growth   = CVECTOR_GROWTH_FACTOR;
+    thiz_data->step     = 200;
+    thiz_data->typesize = typesize;
+    thiz_data->slack    = 0;
+    thiz_data->pending      = NULL;
+    thiz_data->pending_size = 0;
+    thiz_data->pending_offset = 0;
+    thiz_data->migrated     = 0;
+    thiz_data->migrate_end  = 0;
+    thiz_data->migrate_step = 0;
+    thiz_data->share        = NULL;
+    thiz_data->readonly     = 0;
+    thiz_data->first  = ptr;
+    thiz_data->last   = ptr + count * typesize;
+    thiz_data->final  = ptr + capacity * typesize;
+    return cvector_install(thiz_data);
+}
+
+/*   cvector_release: free thiz but keep its items, no item is copied when thiz owns a heap buffer
+ *   thiz: cvector pointer, read size and capacity first
+ *   return: capacity items from malloc, free it with free, NULL if out of memory, thiz is kept then
+ */
+void* cvector_release(cvector *_thiz) {
+	uint64_t used, capacity;
+	void* ptr = NULL;
+	cvector_data *thiz = NULL;
+	if (_thiz == NULL)
+		return NULL;
+	thiz = (cvector_data*) _thiz;
+	cvector_settle(thiz, NULL);
+	used     = thiz->last  - thiz->first;
+	capacity = thiz->final - thiz->first;
+
+	// inline, mapped or shared with snapshots: copy out
+	if (thiz->readonly || (cvector_unshare(thiz, 1) != 0) || (thiz->storage != CVECTOR_BUFFER_HEAP)) {
+		ptr = malloc((capacity > 0) ? capacity : thiz->typesize);
+		if (ptr == NULL)
+			return NULL;
+		if (used > 0)
+			memcpy(ptr, thiz->first, used);
+		_thiz->free(_thiz);
+		return ptr;
+	}
+	// slack mode keeps free items before first
+	ptr = thiz->base;
+	if (thiz->first != ptr)
+		memmove(ptr, thiz->first, used);
+	free(thiz);
+	return ptr;
+}
\ No newline at end of file
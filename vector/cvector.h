@@ -5,6 +5,8 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
+#include "cvector_algo.h"
 
 
 #ifdef __cplusplus
@@ -14,6 +16,16 @@ extern "C"{
 struct cvector_t;
 typedef struct cvector_t cvector;
 
+// growth policy, used when an insert exceeds capacity
+// FACTOR: capacity = needed size * step / 100
+// STEP:   capacity = needed size rounded up to step items
+// EXACT:  capacity = needed size
+enum cvector_growth_t {
+    CVECTOR_GROWTH_FACTOR = 0,
+    CVECTOR_GROWTH_STEP   = 1,
+    CVECTOR_GROWTH_EXACT  = 2,
+};
+
 // vector
 // first                last             end
 // |                     |               |
@@ -183,6 +195,12 @@ struct cvector_t {
  */
     void      (*reverse)(cvector *thiz);
 
+/*   rotate: rotate items left in place, middle item becomes the first
+ *   thiz: cvector pointer
+ *   middle: item pointer, first to last
+ */
+    void      (*rotate)(cvector *thiz, void* middle);
+
 /*   copy: copy value from thiz to that
  *   thiz: cvector pointer
  *   that: cvector pointer
@@ -195,6 +213,143 @@ struct cvector_t {
  *   return: thiz == that
  */
     uint8_t   (*equal)(cvector *thiz, cvector *that);
+
+/*   swap: exchange the items of thiz and that, no item is copied
+ *   inline items move to the heap first, snapshots stay valid, read only vectors are not changed
+ *   thiz: cvector pointer
+ *   that: cvector pointer
+ */
+    void      (*swap)(cvector *thiz, cvector *that);
+
+/*   move_into: free the items of thiz and take the buffer of that, no item is copied
+ *   that becomes empty, on its inline buffer if it has one, else on a new one item buffer
+ *   thiz: cvector pointer
+ *   that: cvector pointer
+ */
+    void      (*move_into)(cvector *thiz, cvector *that);
+
+/*   emplace_back: add one uninitialized last item
+ *   thiz: cvector pointer
+ *   return new item pointer, valid until the next insert, NULL if out of memory
+ */
+    void*     (*emplace_back)(cvector *thiz);
+
+/*   push_back_n: add n items behind, copied from src
+ *   thiz: cvector pointer
+ *   src:  first item pointer
+ *   n:    item count
+ */
+    void      (*push_back_n)(cvector *thiz, const void* src, uint64_t n);
+
+/*   append_uninitialized: add n uninitialized last items
+ *   thiz: cvector pointer
+ *   n:    item count
+ *   return first new item pointer, valid until the next insert, NULL if out of memory
+ */
+    void*     (*append_uninitialized)(cvector *thiz, uint64_t n);
+
+/*   find: first item equal val
+ *   thiz: cvector pointer
+ *   val:  item pointer
+ *   return item pointer, NULL if not found
+ */
+    void*     (*find)(cvector *thiz, const void* val);
+
+/*   rfind: last item equal val
+ *   thiz: cvector pointer
+ *   val:  item pointer
+ *   return item pointer, NULL if not found
+ */
+    void*     (*rfind)(cvector *thiz, const void* val);
+
+/*   count: count items equal val
+ *   thiz: cvector pointer
+ *   val:  item pointer
+ *   return item count equal val
+ */
+    uint64_t  (*count)(cvector *thiz, const void* val);
+
+/*   find_if: first item pred returns non zero
+ *   thiz: cvector pointer
+ *   pred: pred(item, arg)
+ *   arg:  pred user pointer
+ *   return item pointer, NULL if not found
+ */
+    void*     (*find_if)(cvector *thiz, uint8_t (*pred)(const void* item, void* arg), void* arg);
+
+/*   sort: sort items in place, not stable
+ *   thiz: cvector pointer
+ *   cmp:  cmp(a, b) < 0, == 0, > 0 as qsort
+ */
+    void      (*sort)(cvector *thiz, int (*cmp)(const void* a, const void* b));
+
+/*   radix_sort: sort items by an unsigned integer key in linear time, stable
+ *   thiz: cvector pointer
+ *   key_offset: key byte offset in item
+ *   key_width:  key size, 1, 2, 4 or 8, native byte order
+ *   return 0 if success, -1 if bad key or out of memory, items unsorted then
+ */
+    int       (*radix_sort)(cvector *thiz, uint64_t key_offset, uint64_t key_width);
+
+/*   parallel_sort: sort items in place with threads, not stable
+ *   thiz: cvector pointer
+ *   cmp:  cmp(a, b) < 0, == 0, > 0 as qsort
+ *   threads: thread count, 0 for online cpu count
+ */
+    void      (*parallel_sort)(cvector *thiz, int (*cmp)(const void* a, const void* b), uint64_t threads);
+
+/*   lower_bound: first item not less than val, items sorted by cmp
+ *   thiz: cvector pointer
+ *   val:  item pointer
+ *   cmp:  cmp(item, val) < 0, == 0, > 0 as qsort
+ *   return item pointer, end() if every item is less
+ */
+    void*     (*lower_bound)(cvector *thiz, const void* val, int (*cmp)(const void* a, const void* b));
+
+/*   upper_bound: first item greater than val, items sorted by cmp
+ *   thiz: cvector pointer
+ *   val:  item pointer
+ *   cmp:  cmp(item, val) < 0, == 0, > 0 as qsort
+ *   return item pointer, end() if no item is greater
+ */
+    void*     (*upper_bound)(cvector *thiz, const void* val, int (*cmp)(const void* a, const void* b));
+
+/*   equal_range: items equal val, items sorted by cmp
+ *   thiz: cvector pointer
+ *   val:  item pointer
+ *   cmp:  cmp(item, val) < 0, == 0, > 0 as qsort
+ *   first: set to lower_bound
+ *   last:  set to upper_bound
+ */
+    void      (*equal_range)(cvector *thiz, const void* val, int (*cmp)(const void* a, const void* b), void** first, void** last);
+
+/*   sorted_insert: insert val behind its equal items, items sorted by cmp
+ *   thiz: cvector pointer
+ *   val:  item pointer
+ *   cmp:  cmp(item, val) < 0, == 0, > 0 as qsort
+ *   return inserted item pointer, NULL if out of memory
+ */
+    void*     (*sorted_insert)(cvector *thiz, const void* val, int (*cmp)(const void* a, const void* b));
+
+/*   snapshot: O(1) read only view of the items, shares the buffer through a reference count
+ *   thiz: cvector pointer
+ *   thiz copies the buffer on its next change while snapshots are alive, snapshots never
+ *   see it; at, data, front, back, begin, end, rbegin and rend of thiz copy it too, so
+ *   writes through the pointers they return after the snapshot stay in thiz, pointers
+ *   taken before the snapshot must not be written; functions that change a snapshot do
+ *   nothing, writes through its item pointers are not allowed; a snapshot may be read
+ *   and freed from another thread
+ *   return cvector pointer, free it with free, NULL if out of memory
+ */
+    cvector*  (*snapshot)(cvector *thiz);
+
+/*   span: view of the items from first to last, no copy
+ *   thiz: cvector pointer
+ *   first: begin item pointer
+ *   last: end item pointer, not in the span
+ *   return span, valid until the next change, empty if the range is not in thiz
+ */
+    cvector_span (*span)(cvector *thiz, void* first, void* last);
 };
 
 /*   cvector_alloc: malloc cvector pointer
@@ -204,6 +359,143 @@ struct cvector_t {
  */
 cvector* cvector_alloc(uint64_t size, uint64_t typesize);
 
+/*   cvector_alloc_growth: malloc cvector pointer with growth policy
+ *   size:     cvector item count
+ *   typesize: cvector item size
+ *   growth:   CVECTOR_GROWTH_FACTOR, CVECTOR_GROWTH_STEP or CVECTOR_GROWTH_EXACT
+ *   step:     factor in percent (200 doubles), or step item count, unused by EXACT
+ *   return: cvector pointer
+ */
+cvector* cvector_alloc_growth(uint64_t size, uint64_t typesize, uint64_t growth, uint64_t step);
+
+/*   cvector_alloc_inline: malloc cvector pointer, the first items live inline
+ *   size:     cvector item count
+ *   typesize: cvector item size
+ *   inline_count: item count stored inside the cvector allocation,
+ *                 items move to the heap once the vector grows past it
+ *   return: cvector pointer
+ */
+cvector* cvector_alloc_inline(uint64_t size, uint64_t typesize, uint64_t inline_count);
+
+/*   cvector_alloc_slack: malloc cvector pointer, free items kept before first and behind last
+ *   size:     cvector item count
+ *   typesize: cvector item size
+ *   push_front, pop_front and the front half of fill, insert, erase move the head,
+ *   not the tail, so items before the changed position move and data() may change
+ *   return: cvector pointer
+ */
+cvector* cvector_alloc_slack(uint64_t size, uint64_t typesize);
+
+/*   cvector_alloc_incremental: malloc cvector pointer, growth copies items a few per call
+ *   size:     cvector item count
+ *   typesize: cvector item size
+ *   migrate:  item count moved from the old buffer per push_back, emplace_back, at call
+ *   when the buffer grows the old one is kept until its items are moved, at, front
+ *   and back read from either buffer, pointers from them are valid until the next call;
+ *   every other function moves the remaining items first
+ *   return: cvector pointer
+ */
+cvector* cvector_alloc_incremental(uint64_t size, uint64_t typesize, uint64_t migrate);
+
+/*   cvector_adopt: wrap a malloc buffer in a cvector, no item is copied
+ *   ptr:      buffer from malloc, freed by the cvector
+ *   count:    item count in ptr
+ *   capacity: item count ptr holds, >= count
+ *   typesize: cvector item size
+ *   return: cvector pointer, NULL if the arguments are bad or out of memory, ptr is not freed then
+ */
+cvector* cvector_adopt(void* ptr, uint64_t count, uint64_t capacity, uint64_t typesize);
+
+/*   cvector_release: free thiz but keep its items, no item is copied when thiz owns a heap buffer
+ *   inline, page mapped and snapshot shared items are copied to a new buffer
+ *   thiz: cvector pointer, read size and capacity first
+ *   return: capacity items from malloc, free it with free, NULL if out of memory, thiz is kept then
+ */
+void*    cvector_release(cvector *thiz);
+
+
+// leading fields of every cvector from cvector_alloc,
+// read by the inline accessors below, do not write them
+struct cvector_head_t {
+    cvector                    vector;
+    void*                      first;
+    void*                      last;
+    void*                      final;
+    uint64_t                   typesize;
+    void*                      pending;
+};
+
+typedef struct cvector_head_t  cvector_head;
+
+/*   cvector_fast_size: inline size, same result as thiz->size(thiz)
+ *   thiz: cvector pointer
+ *   return  item count
+ */
+static inline uint64_t  cvector_fast_size(cvector *thiz) {
+    const cvector_head *head = (const cvector_head*) thiz;
+    if (thiz == NULL)
+        return 0;
+    return (uint64_t) ((uint8_t*) head->last - (uint8_t*) head->first) / head->typesize;
+}
+
+/*   cvector_fast_at: inline at, same result as thiz->at(thiz, index)
+ *   thiz: cvector pointer
+ *   index: item index
+ *   return index item pointer, NULL if index >= size
+ */
+static inline void*     cvector_fast_at(cvector *thiz, uint64_t index) {
+    const cvector_head *head = (const cvector_head*) thiz;
+    uint64_t used;
+    if (thiz == NULL)
+        return NULL;
+    // items still in the old buffer, see cvector_alloc_incremental
+    if (head->pending != NULL)
+        return thiz->at(thiz, index);
+    // index < used / typesize without a division
+    used = (uint64_t) ((uint8_t*) head->last - (uint8_t*) head->first);
+    if ((index >= used) || (index * head->typesize >= used))
+        return NULL;
+    return (uint8_t*) head->first + index * head->typesize;
+}
+
+/*   cvector_fast_data: inline data, same result as thiz->data(thiz)
+ *   thiz: cvector pointer
+ *   return first item pointer
+ */
+static inline void*     cvector_fast_data(cvector *thiz) {
+    if (thiz == NULL)
+        return NULL;
+    if (((const cvector_head*) thiz)->pending != NULL)
+        return thiz->data(thiz);
+    return ((const cvector_head*) thiz)->first;
+}
+
+/*   cvector_fast_end: inline end, same result as thiz->end(thiz)
+ *   thiz: cvector pointer
+ *   return last item pointer + typesize
+ */
+static inline void*     cvector_fast_end(cvector *thiz) {
+    if (thiz == NULL)
+        return NULL;
+    return ((const cvector_head*) thiz)->last;
+}
+
+/*   cvector_fast_push_back: inline push_back, calls thiz->push_back when full or migrating
+ *   thiz: cvector pointer
+ *   val:  item pointer
+ */
+static inline void      cvector_fast_push_back(cvector *thiz, const void* val) {
+    cvector_head *head = (cvector_head*) thiz;
+    if ((thiz == NULL) || (val == NULL))
+        return;
+    if ((head->pending != NULL) || ((uint64_t) ((uint8_t*) head->final - (uint8_t*) head->last) < head->typesize)) {
+        thiz->push_back(thiz, val);
+        return;
+    }
+    memcpy(head->last, val, head->typesize);
+    head->last = (uint8_t*) head->last + head->typesize;
+}
+
 
 #ifdef __cplusplus
 }
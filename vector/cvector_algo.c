@@ -0,0 +1,972 @@
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CVECTOR_ALGO_X86  1
+#endif
+#include "cvector_algo.h"
+
+
+/*   scalar find, rfind and count for any typesize
+ */
+static    void*    cvector_algo_find_scalar(const void* first, uint64_t count, uint64_t typesize, const void* val) {
+	const uint8_t *ptr = first, *last = ptr + count * typesize;
+	if (typesize == 1)
+		return memchr(first, *((const uint8_t*) val), count);
+	for (; ptr < last; ptr += typesize) {
+		if (memcmp(ptr, val, typesize) == 0)
+			return (void*) ptr;
+	}
+	return NULL;
+}
+
+static    void*    cvector_algo_rfind_scalar(const void* first, uint64_t count, uint64_t typesize, const void* val) {
+	const uint8_t *ptr = (const uint8_t*) first + count * typesize;
+	while (ptr > (const uint8_t*) first) {
+		ptr -= typesize;
+		if (memcmp(ptr, val, typesize) == 0)
+			return (void*) ptr;
+	}
+	return NULL;
+}
+
+static    uint64_t    cvector_algo_count_scalar(const void* first, uint64_t count, uint64_t typesize, const void* val) {
+	const uint8_t *ptr = first, *last = ptr + count * typesize;
+	uint64_t n = 0;
+	for (; ptr < last; ptr += typesize) {
+		if (memcmp(ptr, val, typesize) == 0)
+			++n;
+	}
+	return n;
+}
+
+#ifdef CVECTOR_ALGO_X86
+
+// vector kernels, one set per instruction set and item width W
+// a matching item sets W consecutive movemask bits, aligned to W from the block start
+#define CVECTOR_ALGO_KERNELS(ISA, ATTR, VEC, BYTES, LOADU, MOVEMASK, W, ITEM, SET1, CMPEQ)            \
+static ATTR void*    cvector_algo_find_##ISA##_##W(const void* first, uint64_t count, const void* val) {   \
+	const uint8_t *ptr = first, *last = ptr + count * W;                                               \
+	ITEM item;                                                                                         \
+	VEC key;                                                                                           \
+	uint32_t mask;                                                                                     \
+	memcpy(&item, val, W);                                                                             \
+	key = SET1(item);                                                                                  \
+	for (; ptr + BYTES <= last; ptr += BYTES) {                                                        \
+		mask = (uint32_t) MOVEMASK(CMPEQ(LOADU((const VEC*) ptr), key));                               \
+		if (mask != 0)                                                                                 \
+			return (void*) (ptr + __builtin_ctz(mask));                                                \
+	}                                                                                                  \
+	return cvector_algo_find_scalar(ptr, (last - ptr) / W, W, val);                                    \
+}                                                                                                      \
+                                                                                                       \
+static ATTR void*    cvector_algo_rfind_##ISA##_##W(const void* first, uint64_t count, const void* val) {  \
+	const uint8_t *begin = first, *ptr = begin + count * W;                                            \
+	ITEM item;                                                                                         \
+	VEC key;                                                                                           \
+	uint32_t mask;                                                                                     \
+	memcpy(&item, val, W);                                                                             \
+	key = SET1(item);                                                                                  \
+	for (; ptr >= begin + BYTES; ptr -= BYTES) {                                                       \
+		mask = (uint32_t) MOVEMASK(CMPEQ(LOADU((const VEC*) (ptr - BYTES)), key));                     \
+		if (mask != 0)                                                                                 \
+			return (void*) (ptr - BYTES + (31 - __builtin_clz(mask)) / W * W);                         \
+	}                                                                                                  \
+	return cvector_algo_rfind_scalar(begin, (ptr - begin) / W, W, val);                                \
+}                                                                                                      \
+                                                                                                       \
+static ATTR uint64_t    cvector_algo_count_##ISA##_##W(const void* first, uint64_t count, const void* val) { \
+	const uint8_t *ptr = first, *last = ptr + count * W;                                               \
+	ITEM item;                                                                                         \
+	VEC key;                                                                                           \
+	uint64_t bits = 0;                                                                                 \
+	memcpy(&item, val, W);                                                                             \
+	key = SET1(item);                                                                                  \
+	for (; ptr + BYTES <= last; ptr += BYTES) {                                                        \
+		bits += __builtin_popcount((uint32_t) MOVEMASK(CMPEQ(LOADU((const VEC*) ptr), key)));          \
+	}                                                                                                  \
+	return bits / W + cvector_algo_count_scalar(ptr, (last - ptr) / W, W, val);                        \
+}
+
+// sse2 has no 64 bit compare, both 32 bit halves must match
+static inline __m128i cvector_algo_cmpeq64_sse2(__m128i a, __m128i b) {
+	__m128i eq = _mm_cmpeq_epi32(a, b);
+	return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+#define CVECTOR_ALGO_SSE2(W, ITEM, SET1, CMPEQ) \
+	CVECTOR_ALGO_KERNELS(sse2, __attribute__((target("sse2"))), __m128i, 16, _mm_loadu_si128, _mm_movemask_epi8, W, ITEM, SET1, CMPEQ)
+#define CVECTOR_ALGO_AVX2(W, ITEM, SET1, CMPEQ) \
+	CVECTOR_ALGO_KERNELS(avx2, __attribute__((target("avx2"))), __m256i, 32, _mm256_loadu_si256, _mm256_movemask_epi8, W, ITEM, SET1, CMPEQ)
+
+CVECTOR_ALGO_SSE2(1, int8_t,  _mm_set1_epi8,   _mm_cmpeq_epi8)
+CVECTOR_ALGO_SSE2(2, int16_t, _mm_set1_epi16,  _mm_cmpeq_epi16)
+CVECTOR_ALGO_SSE2(4, int32_t, _mm_set1_epi32,  _mm_cmpeq_epi32)
+CVECTOR_ALGO_SSE2(8, int64_t, _mm_set1_epi64x, cvector_algo_cmpeq64_sse2)
+CVECTOR_ALGO_AVX2(1, int8_t,  _mm256_set1_epi8,   _mm256_cmpeq_epi8)
+CVECTOR_ALGO_AVX2(2, int16_t, _mm256_set1_epi16,  _mm256_cmpeq_epi16)
+CVECTOR_ALGO_AVX2(4, int32_t, _mm256_set1_epi32,  _mm256_cmpeq_epi32)
+CVECTOR_ALGO_AVX2(8, int64_t, _mm256_set1_epi64x, _mm256_cmpeq_epi64)
+
+// reverse kernels, swap one vector from each end with its items in reverse order
+// the items left in the middle, less than two vectors, are swapped one by one
+#define CVECTOR_ALGO_REVERSE(ISA, ATTR, VEC, BYTES, LOADU, STOREU, W, ITEM, REV)                          \
+static ATTR void    cvector_algo_reverse_##ISA##_##W(void* first, uint64_t count) {                    \
+	uint8_t *lo = first, *hi = lo + count * W;                                                         \
+	ITEM a, b;                                                                                         \
+	VEC x, y;                                                                                          \
+	for (; hi - lo >= 2 * BYTES; lo += BYTES, hi -= BYTES) {                                           \
+		x = LOADU((const VEC*) lo);                                                                    \
+		y = LOADU((const VEC*) (hi - BYTES));                                                          \
+		STOREU((VEC*) lo, REV(y));                                                                     \
+		STOREU((VEC*) (hi - BYTES), REV(x));                                                           \
+	}                                                                                                  \
+	for (hi -= W; lo < hi; lo += W, hi -= W) {                                                         \
+		memcpy(&a, lo, W);                                                                             \
+		memcpy(&b, hi, W);                                                                             \
+		memcpy(lo, &b, W);                                                                             \
+		memcpy(hi, &a, W);                                                                             \
+	}                                                                                                  \
+}
+
+// sse2 has no byte shuffle, reverse 16 bit words then swap the bytes of each
+static inline __attribute__((target("sse2"))) __m128i cvector_algo_rev16_sse2(__m128i x) {
+	x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(0, 1, 2, 3));
+	x = _mm_shufflehi_epi16(x, _MM_SHUFFLE(0, 1, 2, 3));
+	return _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2));
+}
+
+static inline __attribute__((target("sse2"))) __m128i cvector_algo_rev8_sse2(__m128i x) {
+	x = cvector_algo_rev16_sse2(x);
+	return _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+}
+
+static inline __attribute__((target("sse2"))) __m128i cvector_algo_rev32_sse2(__m128i x) {
+	return _mm_shuffle_epi32(x, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+static inline __attribute__((target("sse2"))) __m128i cvector_algo_rev64_sse2(__m128i x) {
+	return _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2));
+}
+
+// avx2 shuffles stay in 128 bit lanes, reverse in each lane then swap the lanes
+static inline __attribute__((target("avx2"))) __m256i cvector_algo_rev8_avx2(__m256i x) {
+	const __m256i mask = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+	                                      15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+	return _mm256_permute4x64_epi64(_mm256_shuffle_epi8(x, mask), _MM_SHUFFLE(1, 0, 3, 2));
+}
+
+static inline __attribute__((target("avx2"))) __m256i cvector_algo_rev16_avx2(__m256i x) {
+	const __m256i mask = _mm256_setr_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1,
+	                                      14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+	return _mm256_permute4x64_epi64(_mm256_shuffle_epi8(x, mask), _MM_SHUFFLE(1, 0, 3, 2));
+}
+
+static inline __attribute__((target("avx2"))) __m256i cvector_algo_rev32_avx2(__m256i x) {
+	return _mm256_permutevar8x32_epi32(x, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+}
+
+static inline __attribute__((target("avx2"))) __m256i cvector_algo_rev64_avx2(__m256i x) {
+	return _mm256_permute4x64_epi64(x, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+#define CVECTOR_ALGO_REVERSE_SSE2(W, ITEM, REV) \
+	CVECTOR_ALGO_REVERSE(sse2, __attribute__((target("sse2"))), __m128i, 16, _mm_loadu_si128, _mm_storeu_si128, W, ITEM, REV)
+#define CVECTOR_ALGO_REVERSE_AVX2(W, ITEM, REV) \
+	CVECTOR_ALGO_REVERSE(avx2, __attribute__((target("avx2"))), __m256i, 32, _mm256_loadu_si256, _mm256_storeu_si256, W, ITEM, REV)
+
+CVECTOR_ALGO_REVERSE_SSE2(1, int8_t,  cvector_algo_rev8_sse2)
+CVECTOR_ALGO_REVERSE_SSE2(2, int16_t, cvector_algo_rev16_sse2)
+CVECTOR_ALGO_REVERSE_SSE2(4, int32_t, cvector_algo_rev32_sse2)
+CVECTOR_ALGO_REVERSE_SSE2(8, int64_t, cvector_algo_rev64_sse2)
+CVECTOR_ALGO_REVERSE_AVX2(1, int8_t,  cvector_algo_rev8_avx2)
+CVECTOR_ALGO_REVERSE_AVX2(2, int16_t, cvector_algo_rev16_avx2)
+CVECTOR_ALGO_REVERSE_AVX2(4, int32_t, cvector_algo_rev32_avx2)
+CVECTOR_ALGO_REVERSE_AVX2(8, int64_t, cvector_algo_rev64_avx2)
+
+struct cvector_algo_kernel_t {
+    void*        (*find)(const void* first, uint64_t count, const void* val);
+    void*        (*rfind)(const void* first, uint64_t count, const void* val);
+    uint64_t     (*count)(const void* first, uint64_t count, const void* val);
+    void         (*reverse)(void* first, uint64_t count);
+};
+
+typedef struct cvector_algo_kernel_t  cvector_algo_kernel;
+
+#define CVECTOR_ALGO_ENTRY(ISA, W)  {cvector_algo_find_##ISA##_##W, cvector_algo_rfind_##ISA##_##W, \
+	cvector_algo_count_##ISA##_##W, cvector_algo_reverse_##ISA##_##W}
+
+// index 0..3 for typesize 1, 2, 4, 8
+static const cvector_algo_kernel cvector_algo_sse2[] = {
+	CVECTOR_ALGO_ENTRY(sse2, 1), CVECTOR_ALGO_ENTRY(sse2, 2), CVECTOR_ALGO_ENTRY(sse2, 4), CVECTOR_ALGO_ENTRY(sse2, 8),
+};
+
+static const cvector_algo_kernel cvector_algo_avx2[] = {
+	CVECTOR_ALGO_ENTRY(avx2, 1), CVECTOR_ALGO_ENTRY(avx2, 2), CVECTOR_ALGO_ENTRY(avx2, 4), CVECTOR_ALGO_ENTRY(avx2, 8),
+};
+
+static    const cvector_algo_kernel    *cvector_algo_chosen = NULL;
+
+static    pthread_once_t    cvector_algo_once = PTHREAD_ONCE_INIT;
+
+/*   kernel_init: choose the kernel table by cpu, run once
+ */
+static    void    cvector_algo_kernel_init() {
+	__builtin_cpu_init();
+	cvector_algo_chosen = __builtin_cpu_supports("avx2") ? cvector_algo_avx2 : cvector_algo_sse2;
+}
+
+/*   kernel: vector kernels for typesize, table chosen once under pthread_once
+ *   typesize: item size
+ *   return kernel pointer, NULL if typesize has no vector kernel
+ */
+static    const cvector_algo_kernel*    cvector_algo_kernel_get(uint64_t typesize) {
+	const cvector_algo_kernel *kernel = NULL;
+	pthread_once(&cvector_algo_once, cvector_algo_kernel_init);
+	kernel = cvector_algo_chosen;
+	switch (typesize) {
+	case 1: return &kernel[0];
+	case 2: return &kernel[1];
+	case 4: return &kernel[2];
+	case 8: return &kernel[3];
+	default: return NULL;
+	}
+}
+
+#endif
+
+/*   cvector_algo_find: first item equal val
+ *   first:    first item pointer
+ *   count:    item count
+ *   typesize: item size
+ *   val:      item pointer
+ *   return: item pointer, NULL if not found
+ */
+void*    cvector_algo_find(const void* first, uint64_t count, uint64_t typesize, const void* val) {
+	if ((first == NULL) || (val == NULL) || (count <= 0) || (typesize <= 0))
+		return NULL;
+#ifdef CVECTOR_ALGO_X86
+	if (cvector_algo_kernel_get(typesize) != NULL)
+		return cvector_algo_kernel_get(typesize)->find(first, count, val);
+#endif
+	return cvector_algo_find_scalar(first, count, typesize, val);
+}
+
+/*   cvector_algo_rfind: last item equal val
+ *   first:    first item pointer
+ *   count:    item count
+ *   typesize: item size
+ *   val:      item pointer
+ *   return: item pointer, NULL if not found
+ */
+void*    cvector_algo_rfind(const void* first, uint64_t count, uint64_t typesize, const void* val) {
+	if ((first == NULL) || (val == NULL) || (count <= 0) || (typesize <= 0))
+		return NULL;
+#ifdef CVECTOR_ALGO_X86
+	if (cvector_algo_kernel_get(typesize) != NULL)
+		return cvector_algo_kernel_get(typesize)->rfind(first, count, val);
+#endif
+	return cvector_algo_rfind_scalar(first, count, typesize, val);
+}
+
+/*   cvector_algo_count: count items equal val
+ *   first:    first item pointer
+ *   count:    item count
+ *   typesize: item size
+ *   val:      item pointer
+ *   return: item count equal val
+ */
+uint64_t cvector_algo_count(const void* first, uint64_t count, uint64_t typesize, const void* val) {
+	if ((first == NULL) || (val == NULL) || (count <= 0) || (typesize <= 0))
+		return 0;
+#ifdef CVECTOR_ALGO_X86
+	if (cvector_algo_kernel_get(typesize) != NULL)
+		return cvector_algo_kernel_get(typesize)->count(first, count, val);
+#endif
+	return cvector_algo_count_scalar(first, count, typesize, val);
+}
+
+/*   cvector_algo_find_if: first item pred returns non zero
+ *   first:    first item pointer
+ *   count:    item count
+ *   typesize: item size
+ *   pred:     pred(item, arg)
+ *   arg:      pred user pointer
+ *   return: item pointer, NULL if not found
+ */
+void*    cvector_algo_find_if(const void* first, uint64_t count, uint64_t typesize,
+                              uint8_t (*pred)(const void* item, void* arg), void* arg) {
+	const uint8_t *ptr = first, *last = NULL;
+	if ((first == NULL) || (pred == NULL) || (typesize <= 0))
+		return NULL;
+	last = ptr + count * typesize;
+	for (; ptr < last; ptr += typesize) {
+		if (pred(ptr, arg))
+			return (void*) ptr;
+	}
+	return NULL;
+}
+
+// branchless binary search: the range halves every step, the compare result only
+// picks the next base (a conditional move), both candidate halves are prefetched
+#define CVECTOR_ALGO_BOUND(NAME, TEST)                                                                 \
+void*    NAME(const void* first, uint64_t count, uint64_t typesize, const void* val,                   \
+              int (*cmp)(const void* a, const void* b)) {                                              \
+	const uint8_t *base = first;                                                                       \
+	uint64_t half;                                                                                     \
+	if ((first == NULL) || (val == NULL) || (cmp == NULL) || (typesize <= 0))                          \
+		return NULL;                                                                                   \
+	if (count <= 0)                                                                                    \
+		return (void*) base;                                                                           \
+	while (count > 1) {                                                                                \
+		half = count / 2;                                                                              \
+		__builtin_prefetch(base + (half / 2) * typesize);                                              \
+		__builtin_prefetch(base + (half + half / 2) * typesize);                                       \
+		base = (cmp(base + half * typesize, val) TEST 0) ? (base + half * typesize) : base;            \
+		count -= half;                                                                                 \
+	}                                                                                                  \
+	return (void*) ((cmp(base, val) TEST 0) ? (base + typesize) : base);                               \
+}
+
+/*   cvector_algo_lower_bound: first item not less than val, items sorted by cmp
+ */
+CVECTOR_ALGO_BOUND(cvector_algo_lower_bound, <)
+
+/*   cvector_algo_upper_bound: first item greater than val, items sorted by cmp
+ */
+CVECTOR_ALGO_BOUND(cvector_algo_upper_bound, <=)
+
+/*   swap: swap two items, typesize is a constant in the sort kernels
+ */
+static inline __attribute__((always_inline)) void cvector_algo_swap(uint8_t* a, uint8_t* b, uint64_t typesize) {
+	uint8_t tmp[64];
+	uint64_t n;
+	while (typesize > 0) {
+		n = (typesize < sizeof(tmp)) ? typesize : sizeof(tmp);
+		memcpy(tmp, a, n);
+		memcpy(a, b, n);
+		memcpy(b, tmp, n);
+		a += n;
+		b += n;
+		typesize -= n;
+	}
+}
+
+/*   median: index of the median of a, b and c
+ */
+static inline __attribute__((always_inline)) uint64_t cvector_algo_median(uint8_t* first, uint64_t a, uint64_t b, uint64_t c,
+	                                  uint64_t typesize, int (*cmp)(const void*, const void*)) {
+	if (cmp(first + a * typesize, first + b * typesize) < 0) {
+		if (cmp(first + b * typesize, first + c * typesize) < 0)
+			return b;
+		return (cmp(first + a * typesize, first + c * typesize) < 0) ? c : a;
+	}
+	if (cmp(first + a * typesize, first + c * typesize) < 0)
+		return a;
+	return (cmp(first + b * typesize, first + c * typesize) < 0) ? c : b;
+}
+
+/*   heap_sort: sort count items stride bytes apart, fallback for bad pivots and strided spans
+ */
+static inline __attribute__((always_inline)) void cvector_algo_heap_sort(uint8_t* first, uint64_t count, uint64_t stride,
+	                                  uint64_t typesize, int (*cmp)(const void*, const void*)) {
+	uint64_t start, end, root, child;
+	for (end = count, start = count / 2; ; ) {
+		if (start > 0) {
+			--start;
+		} else {
+			if (--end == 0)
+				return;
+			cvector_algo_swap(first, first + end * stride, typesize);
+		}
+		for (root = start; (child = 2 * root + 1) < end; root = child) {
+			if ((child + 1 < end) && (cmp(first + child * stride, first + (child + 1) * stride) < 0))
+				++child;
+			if (cmp(first + root * stride, first + child * stride) >= 0)
+				break;
+			cvector_algo_swap(first + root * stride, first + child * stride, typesize);
+		}
+	}
+}
+
+#define CVECTOR_ALGO_SORT_SMALL  (16)
+
+// introsort: quicksort with median of three (ninther on large ranges),
+// heap sort once depth runs out, insertion sort on short ranges.
+// ranges wait on an explicit stack, the larger side is pushed so depth stays log2(count)
+static inline __attribute__((always_inline)) void cvector_algo_sort_core(uint8_t* base, uint64_t count,
+	                                  uint64_t typesize, int (*cmp)(const void*, const void*)) {
+	struct { uint64_t lo, hi, depth; } stack[64];
+	uint64_t top = 0, lo = 0, hi = count, depth = 0, n, m, i, j;
+	uint8_t *first, *pivot;
+
+	for (n = count; n > 1; n >>= 1)
+		depth += 2;
+
+	for (;;) {
+		n = hi - lo;
+		first = base + lo * typesize;
+		if (n <= CVECTOR_ALGO_SORT_SMALL) {
+			for (i = 1; i < n; ++i) {
+				for (j = i; (j > 0) && (cmp(first + (j - 1) * typesize, first + j * typesize) > 0); --j)
+					cvector_algo_swap(first + (j - 1) * typesize, first + j * typesize, typesize);
+			}
+		} else if (depth == 0) {
+			cvector_algo_heap_sort(first, n, typesize, typesize, cmp);
+		} else {
+			--depth;
+			m = n / 2;
+			if (n > 128) {
+				m = cvector_algo_median(first,
+					cvector_algo_median(first, 0, n / 8, n / 4, typesize, cmp),
+					cvector_algo_median(first, m - n / 8, m, m + n / 8, typesize, cmp),
+					cvector_algo_median(first, n - 1 - n / 4, n - 1 - n / 8, n - 1, typesize, cmp),
+					typesize, cmp);
+			} else {
+				m = cvector_algo_median(first, 0, m, n - 1, typesize, cmp);
+			}
+			// pivot at first, equal items stop both scans so duplicates split evenly
+			cvector_algo_swap(first, first + m * typesize, typesize);
+			pivot = first;
+			i = 0;
+			j = n;
+			for (;;) {
+				while (cmp(first + (++i) * typesize, pivot) < 0) {
+					if (i == n - 1)
+						break;
+				}
+				while (cmp(pivot, first + (--j) * typesize) < 0) {
+					if (j == 0)
+						break;
+				}
+				if (i >= j)
+					break;
+				cvector_algo_swap(first + i * typesize, first + j * typesize, typesize);
+			}
+			cvector_algo_swap(first, first + j * typesize, typesize);
+
+			// [lo, lo + j) and [lo + j + 1, hi)
+			if (j < n - 1 - j) {
+				stack[top].lo = lo + j + 1;
+				stack[top].hi = hi;
+				stack[top].depth = depth;
+				++top;
+				hi = lo + j;
+			} else {
+				stack[top].lo = lo;
+				stack[top].hi = lo + j;
+				stack[top].depth = depth;
+				++top;
+				lo = lo + j + 1;
+			}
+			continue;
+		}
+		if (top == 0)
+			return;
+		--top;
+		lo    = stack[top].lo;
+		hi    = stack[top].hi;
+		depth = stack[top].depth;
+	}
+}
+
+#define CVECTOR_ALGO_SORT(W)                                                                            \
+static    void    cvector_algo_sort_##W(void* first, uint64_t count, int (*cmp)(const void*, const void*)) { \
+	cvector_algo_sort_core(first, count, W, cmp);                                                       \
+}
+
+CVECTOR_ALGO_SORT(1)
+CVECTOR_ALGO_SORT(2)
+CVECTOR_ALGO_SORT(4)
+CVECTOR_ALGO_SORT(8)
+CVECTOR_ALGO_SORT(16)
+
+/*   cvector_algo_sort: sort items in place, not stable
+ *   first:    first item pointer
+ *   count:    item count
+ *   typesize: item size
+ *   cmp:      cmp(a, b) < 0, == 0, > 0 as qsort
+ */
+void     cvector_algo_sort(void* first, uint64_t count, uint64_t typesize, int (*cmp)(const void* a, const void* b)) {
+	if ((first == NULL) || (cmp == NULL) || (count <= 1) || (typesize <= 0))
+		return;
+	switch (typesize) {
+	case 1:  cvector_algo_sort_1(first, count, cmp);  return;
+	case 2:  cvector_algo_sort_2(first, count, cmp);  return;
+	case 4:  cvector_algo_sort_4(first, count, cmp);  return;
+	case 8:  cvector_algo_sort_8(first, count, cmp);  return;
+	case 16: cvector_algo_sort_16(first, count, cmp); return;
+	default: cvector_algo_sort_core(first, count, typesize, cmp); return;
+	}
+}
+
+/*   reverse_core: swap items from both ends, typesize is a constant in the callers
+ */
+static inline __attribute__((always_inline)) void cvector_algo_reverse_core(uint8_t* lo, uint64_t count, uint64_t typesize) {
+	uint8_t *hi = lo + (count - 1) * typesize;
+	for (; lo < hi; lo += typesize, hi -= typesize)
+		cvector_algo_swap(lo, hi, typesize);
+}
+
+/*   cvector_algo_reverse: reverse items in place
+ *   first:    first item pointer
+ *   count:    item count
+ *   typesize: item size
+ */
+void     cvector_algo_reverse(void* first, uint64_t count, uint64_t typesize) {
+	if ((first == NULL) || (count <= 1) || (typesize <= 0))
+		return;
+#ifdef CVECTOR_ALGO_X86
+	if (cvector_algo_kernel_get(typesize) != NULL) {
+		cvector_algo_kernel_get(typesize)->reverse(first, count);
+		return;
+	}
+#endif
+	switch (typesize) {
+	case 16: cvector_algo_reverse_core(first, count, 16); return;
+	case 32: cvector_algo_reverse_core(first, count, 32); return;
+	default: cvector_algo_reverse_core(first, count, typesize); return;
+	}
+}
+
+/*   swap_block: swap two blocks of bytes through a stack chunk, they do not overlap
+ */
+static    void    cvector_algo_swap_block(uint8_t* a, uint8_t* b, uint64_t size, uint8_t* tmp, uint64_t chunk) {
+	uint64_t n;
+	for (; size > 0; a += n, b += n, size -= n) {
+		n = (size < chunk) ? size : chunk;
+		memcpy(tmp, a, n);
+		memcpy(a, b, n);
+		memcpy(b, tmp, n);
+	}
+}
+
+/*   cvector_algo_rotate: rotate items left, middle item becomes the first
+ *   first:    first item pointer
+ *   count:    item count
+ *   typesize: item size
+ *   middle:   middle item index, <= count
+ */
+void     cvector_algo_rotate(void* first, uint64_t count, uint64_t typesize, uint64_t middle) {
+	uint8_t  tmp[1024], *ptr = first;
+	uint64_t left, right;
+	if ((first == NULL) || (typesize <= 0) || (middle <= 0) || (middle >= count))
+		return;
+	left  = middle * typesize;
+	right = (count - middle) * typesize;
+#ifdef CVECTOR_ALGO_X86
+	// small items reverse a vector at a time, (a b)' = b' a'
+	if ((left > sizeof(tmp)) && (right > sizeof(tmp)) && (cvector_algo_kernel_get(typesize) != NULL)) {
+		cvector_algo_reverse(first, middle, typesize);
+		cvector_algo_reverse(ptr + left, count - middle, typesize);
+		cvector_algo_reverse(first, count, typesize);
+		return;
+	}
+#endif
+	// swap the shorter block into its final place, then rotate the rest, no heap
+	while (left > sizeof(tmp) && right > sizeof(tmp)) {
+		if (left <= right) {
+			cvector_algo_swap_block(ptr, ptr + left, left, tmp, sizeof(tmp));
+			ptr   += left;
+			right -= left;
+		} else {
+			cvector_algo_swap_block(ptr, ptr + left, right, tmp, sizeof(tmp));
+			ptr  += right;
+			left -= right;
+		}
+	}
+	// the shorter block fits on the stack, one memmove shifts the other
+	if (left <= right) {
+		memcpy(tmp, ptr, left);
+		memmove(ptr, ptr + left, right);
+		memcpy(ptr + right, tmp, left);
+	} else {
+		memcpy(tmp, ptr + left, right);
+		memmove(ptr + right, ptr, left);
+		memcpy(ptr, tmp, right);
+	}
+}
+
+/*   radix_key: load key_width bytes at ptr as a native unsigned integer
+ */
+static inline __attribute__((always_inline)) uint64_t cvector_algo_radix_key(const uint8_t* ptr, uint64_t key_width) {
+	uint8_t  k8;
+	uint16_t k16;
+	uint32_t k32;
+	uint64_t k64;
+	switch (key_width) {
+	case 1:  memcpy(&k8,  ptr, 1); return k8;
+	case 2:  memcpy(&k16, ptr, 2); return k16;
+	case 4:  memcpy(&k32, ptr, 4); return k32;
+	default: memcpy(&k64, ptr, 8); return k64;
+	}
+}
+
+// lsd radix sort, 8 bit digits, all histograms in one pass,
+// digits every item shares are skipped
+static inline __attribute__((always_inline)) int cvector_algo_radix_core(uint8_t* first, uint64_t count, uint64_t typesize,
+	                                  uint64_t key_offset, uint64_t key_width) {
+	uint64_t (*hist)[256] = NULL;
+	uint64_t i, pass, digit, sum, next;
+	uint8_t *src = first, *dst = NULL, *tmp = NULL, *ptr;
+
+	hist = calloc(key_width, sizeof(*hist));
+	dst  = malloc(count * typesize);
+	if ((hist == NULL) || (dst == NULL)) {
+		free(hist);
+		free(dst);
+		return -1;
+	}
+	tmp = dst;
+
+	for (i = 0, ptr = src; i < count; ++i, ptr += typesize) {
+		uint64_t key = cvector_algo_radix_key(ptr + key_offset, key_width);
+		for (pass = 0; pass < key_width; ++pass)
+			++hist[pass][(key >> (pass * 8)) & 0xff];
+	}
+
+	for (pass = 0; pass < key_width; ++pass) {
+		if (hist[pass][(cvector_algo_radix_key(src + key_offset, key_width) >> (pass * 8)) & 0xff] == count)
+			continue;
+		for (digit = 0, sum = 0; digit < 256; ++digit) {
+			next = sum + hist[pass][digit];
+			hist[pass][digit] = sum;
+			sum = next;
+		}
+		for (i = 0, ptr = src; i < count; ++i, ptr += typesize) {
+			digit = (cvector_algo_radix_key(ptr + key_offset, key_width) >> (pass * 8)) & 0xff;
+			memcpy(dst + (hist[pass][digit]++) * typesize, ptr, typesize);
+		}
+		ptr = src;
+		src = dst;
+		dst = ptr;
+	}
+
+	if (src != first)
+		memcpy(first, src, count * typesize);
+	free(tmp);
+	free(hist);
+	return 0;
+}
+
+#define CVECTOR_ALGO_RADIX(W)                                                                           \
+static    int    cvector_algo_radix_##W(void* first, uint64_t count, uint64_t key_offset, uint64_t key_width) { \
+	return cvector_algo_radix_core(first, count, W, key_offset, key_width);                             \
+}
+
+CVECTOR_ALGO_RADIX(4)
+CVECTOR_ALGO_RADIX(8)
+CVECTOR_ALGO_RADIX(16)
+
+/*   cvector_algo_radix_sort: sort items by an unsigned integer key, stable
+ *   first:      first item pointer
+ *   count:      item count
+ *   typesize:   item size
+ *   key_offset: key byte offset in item
+ *   key_width:  key size, 1, 2, 4 or 8, native byte order
+ *   return: 0 if success, -1 if bad key or out of memory
+ */
+int      cvector_algo_radix_sort(void* first, uint64_t count, uint64_t typesize, uint64_t key_offset, uint64_t key_width) {
+	if ((first == NULL) || (typesize <= 0))
+		return -1;
+	if (((key_width != 1) && (key_width != 2) && (key_width != 4) && (key_width != 8)) || (key_offset + key_width > typesize))
+		return -1;
+	if (count <= 1)
+		return 0;
+	switch (typesize) {
+	case 4:  return cvector_algo_radix_4(first, count, key_offset, key_width);
+	case 8:  return cvector_algo_radix_8(first, count, key_offset, key_width);
+	case 16: return cvector_algo_radix_16(first, count, key_offset, key_width);
+	default: return cvector_algo_radix_core(first, count, typesize, key_offset, key_width);
+	}
+}
+
+// parallel sort: threads sort equal runs, then rounds of pairwise merges.
+// every merge is cut along merge path diagonals so all threads share each round
+#define CVECTOR_ALGO_PARALLEL_MIN   (1 << 16)
+#define CVECTOR_ALGO_THREADS_MAX    (256)
+
+struct cvector_algo_task_t {
+    uint8_t      *a;        // sort/copy: items, merge: first run
+    uint8_t      *b;        // merge: second run
+    uint8_t      *out;      // merge/copy: destination
+    uint64_t      na;       // sort/copy: item count, merge: first run count
+    uint64_t      nb;       // merge: second run count
+    uint64_t      lo;       // merge: first output index
+    uint64_t      hi;       // merge: last output index
+    uint64_t      typesize;
+    int          (*cmp)(const void*, const void*);
+    uint8_t       type;     // 0 sort, 1 merge, 2 copy
+};
+
+typedef struct cvector_algo_task_t  cvector_algo_task;
+
+/*   co_rank: count of a items among the first diag merged items, ties take a first
+ */
+static    uint64_t    cvector_algo_co_rank(const cvector_algo_task *task, uint64_t diag) {
+	uint64_t lo, hi, mid, ts = task->typesize;
+	lo = (diag > task->nb) ? (diag - task->nb) : 0;
+	hi = (diag < task->na) ? diag : task->na;
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (task->cmp(task->a + mid * ts, task->b + (diag - mid - 1) * ts) <= 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+static    void*    cvector_algo_task_run(void* arg) {
+	cvector_algo_task *task = arg;
+	uint64_t i, j, i_end, j_end, ts = task->typesize;
+	uint8_t *out;
+	if (task->type == 0) {
+		cvector_algo_sort(task->a, task->na, ts, task->cmp);
+	} else if (task->type == 2) {
+		memcpy(task->out, task->a, task->na * ts);
+	} else {
+		i     = cvector_algo_co_rank(task, task->lo);
+		i_end = cvector_algo_co_rank(task, task->hi);
+		j     = task->lo - i;
+		j_end = task->hi - i_end;
+		out   = task->out + task->lo * ts;
+		while ((i < i_end) && (j < j_end)) {
+			if (task->cmp(task->a + i * ts, task->b + j * ts) <= 0) {
+				memcpy(out, task->a + (i++) * ts, ts);
+			} else {
+				memcpy(out, task->b + (j++) * ts, ts);
+			}
+			out += ts;
+		}
+		if (i < i_end)
+			memcpy(out, task->a + i * ts, (i_end - i) * ts);
+		if (j < j_end)
+			memcpy(out, task->b + j * ts, (j_end - j) * ts);
+	}
+	return NULL;
+}
+
+/*   tasks_run: run count tasks, one thread each, the caller runs the first
+ *   tasks whose thread cannot start run on the caller
+ */
+static    void    cvector_algo_tasks_run(cvector_algo_task *tasks, uint64_t count) {
+	pthread_t threads[CVECTOR_ALGO_THREADS_MAX + 1];
+	uint64_t i, started;
+	for (started = 1; started < count; ++started) {
+		if (pthread_create(&threads[started], NULL, cvector_algo_task_run, &tasks[started]) != 0)
+			break;
+	}
+	cvector_algo_task_run(&tasks[0]);
+	// tasks whose thread failed run here
+	for (i = started; i < count; ++i)
+		cvector_algo_task_run(&tasks[i]);
+	for (i = 1; i < started; ++i)
+		pthread_join(threads[i], NULL);
+}
+
+/*   cvector_algo_parallel_sort: sort items in place with threads, not stable
+ *   first:    first item pointer
+ *   count:    item count
+ *   typesize: item size
+ *   cmp:      cmp(a, b) < 0, == 0, > 0 as qsort
+ *   threads:  thread count, 0 for online cpu count
+ *   return: 0 if success, -1 if out of memory
+ */
+int      cvector_algo_parallel_sort(void* first, uint64_t count, uint64_t typesize,
+                                    int (*cmp)(const void* a, const void* b), uint64_t threads) {
+	cvector_algo_task tasks[CVECTOR_ALGO_THREADS_MAX + 1];
+	uint64_t runs[CVECTOR_ALGO_THREADS_MAX + 1];
+	uint64_t i, k, n, pairs, share, total, ntask;
+	uint8_t *src = first, *dst = NULL, *tmp = NULL;
+	long cpus;
+
+	if ((first == NULL) || (cmp == NULL) || (typesize <= 0))
+		return -1;
+	if (threads <= 0) {
+		cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		threads = (cpus > 0) ? (uint64_t) cpus : 1;
+	}
+	if (threads > CVECTOR_ALGO_THREADS_MAX)
+		threads = CVECTOR_ALGO_THREADS_MAX;
+	if (threads > count / CVECTOR_ALGO_PARALLEL_MIN)
+		threads = count / CVECTOR_ALGO_PARALLEL_MIN;
+	if (threads <= 1) {
+		cvector_algo_sort(first, count, typesize, cmp);
+		return 0;
+	}
+
+	dst = malloc(count * typesize);
+	if (dst == NULL)
+		return -1;
+	tmp = dst;
+
+	for (i = 0; i <= threads; ++i)
+		runs[i] = count * i / threads;
+	for (i = 0; i < threads; ++i) {
+		tasks[i].type     = 0;
+		tasks[i].a        = src + runs[i] * typesize;
+		tasks[i].na       = runs[i + 1] - runs[i];
+		tasks[i].typesize = typesize;
+		tasks[i].cmp      = cmp;
+	}
+	cvector_algo_tasks_run(tasks, threads);
+
+	for (n = threads; n > 1; n = (n + 1) / 2) {
+		pairs = n / 2;
+		share = threads / pairs;
+		ntask = 0;
+		for (k = 0; k < pairs; ++k) {
+			total = runs[2 * k + 2] - runs[2 * k];
+			for (i = 0; i < share; ++i, ++ntask) {
+				tasks[ntask].type     = 1;
+				tasks[ntask].a        = src + runs[2 * k] * typesize;
+				tasks[ntask].na       = runs[2 * k + 1] - runs[2 * k];
+				tasks[ntask].b        = src + runs[2 * k + 1] * typesize;
+				tasks[ntask].nb       = runs[2 * k + 2] - runs[2 * k + 1];
+				tasks[ntask].out      = dst + runs[2 * k] * typesize;
+				tasks[ntask].lo       = total * i / share;
+				tasks[ntask].hi       = total * (i + 1) / share;
+				tasks[ntask].typesize = typesize;
+				tasks[ntask].cmp      = cmp;
+			}
+		}
+		// odd run has no partner, it moves as is
+		if (n % 2) {
+			tasks[ntask].type     = 2;
+			tasks[ntask].a        = src + runs[n - 1] * typesize;
+			tasks[ntask].na       = runs[n] - runs[n - 1];
+			tasks[ntask].out      = dst + runs[n - 1] * typesize;
+			tasks[ntask].typesize = typesize;
+			++ntask;
+		}
+		cvector_algo_tasks_run(tasks, ntask);
+
+		for (k = 0; k <= pairs; ++k)
+			runs[k] = runs[(2 * k < n) ? 2 * k : n];
+		runs[(n + 1) / 2] = count;
+		src = (src == first) ? tmp : first;
+		dst = (dst == first) ? tmp : first;
+	}
+
+	if (src != first) {
+		for (i = 0; i < threads; ++i) {
+			tasks[i].type     = 2;
+			tasks[i].a        = src + (count * i / threads) * typesize;
+			tasks[i].na       = count * (i + 1) / threads - count * i / threads;
+			tasks[i].out      = (uint8_t*) first + (count * i / threads) * typesize;
+			tasks[i].typesize = typesize;
+		}
+		cvector_algo_tasks_run(tasks, threads);
+	}
+	free(tmp);
+	return 0;
+}
+
+/*   cvector_span_find: first item equal val
+ *   span: span
+ *   val:  item pointer
+ *   return: item pointer, NULL if not found
+ */
+void*    cvector_span_find(cvector_span span, const void* val) {
+	uint8_t *ptr = span.first;
+	uint64_t i;
+	if ((ptr == NULL) || (val == NULL))
+		return NULL;
+	if (span.stride == span.typesize)
+		return cvector_algo_find(ptr, span.count, span.typesize, val);
+	for (i = 0; i < span.count; ++i, ptr += span.stride) {
+		if (memcmp(ptr, val, span.typesize) == 0)
+			return ptr;
+	}
+	return NULL;
+}
+
+/*   cvector_span_count: count items equal val
+ *   span: span
+ *   val:  item pointer
+ *   return: item count equal val
+ */
+uint64_t cvector_span_count(cvector_span span, const void* val) {
+	uint8_t *ptr = span.first;
+	uint64_t i, n = 0;
+	if ((ptr == NULL) || (val == NULL))
+		return 0;
+	if (span.stride == span.typesize)
+		return cvector_algo_count(ptr, span.count, span.typesize, val);
+	for (i = 0; i < span.count; ++i, ptr += span.stride) {
+		if (memcmp(ptr, val, span.typesize) == 0)
+			++n;
+	}
+	return n;
+}
+
+/*   cvector_span_sort: sort items in place, not stable
+ *   span: span
+ *   cmp:  cmp(a, b) < 0, == 0, > 0 as qsort
+ */
+void     cvector_span_sort(cvector_span span, int (*cmp)(const void* a, const void* b)) {
+	if ((span.first == NULL) || (cmp == NULL) || (span.count <= 1))
+		return;
+	if (span.stride == span.typesize) {
+		cvector_algo_sort(span.first, span.count, span.typesize, cmp);
+		return;
+	}
+	// strided items sort where they are, heap sort needs no gather buffer
+	cvector_algo_heap_sort(span.first, span.count, span.stride, span.typesize, cmp);
+}
+
+/*   cvector_span_equal: item count and items equal
+ *   a:    span
+ *   b:    span
+ *   return: 1 if equal
+ */
+uint8_t  cvector_span_equal(cvector_span a, cvector_span b) {
+	const uint8_t *pa = a.first, *pb = b.first;
+	uint64_t i;
+	if ((a.typesize != b.typesize) || (a.count != b.count))
+		return 0;
+	if ((a.count == 0) || (pa == pb && a.stride == b.stride))
+		return 1;
+	if ((a.stride == a.typesize) && (b.stride == b.typesize))
+		return (memcmp(pa, pb, a.count * a.typesize) == 0) ? 1 : 0;
+	for (i = 0; i < a.count; ++i, pa += a.stride, pb += b.stride) {
+		if (memcmp(pa, pb, a.typesize) != 0)
+			return 0;
+	}
+	return 1;
+}
+
+/*   hash_mix: fold an 8 byte word into h
+ */
+static inline uint64_t    cvector_algo_hash_mix(uint64_t h, uint64_t word) {
+	h ^= word * 0x9e3779b97f4a7c15ULL;
+	h  = (h << 31) | (h >> 33);
+	return h * 0xbf58476d1ce4e5b9ULL;
+}
+
+/*   cvector_span_hash: 64 bit hash of the item bytes, equal spans hash equal whatever the stride
+ *   span: span
+ *   return: hash
+ */
+uint64_t cvector_span_hash(cvector_span span) {
+	const uint8_t *ptr = span.first;
+	uint64_t i, n, word, h = cvector_algo_hash_mix(0x84222325cbf29ce4ULL, span.count * span.typesize);
+	for (i = 0; (ptr != NULL) && (i < span.count); ++i, ptr += span.stride) {
+		// item by item, a word at a time, so contiguous and strided spans agree
+		for (n = 0; n + 8 <= span.typesize; n += 8) {
+			memcpy(&word, ptr + n, 8);
+			h = cvector_algo_hash_mix(h, word);
+		}
+		if (n < span.typesize) {
+			word = 0;
+			memcpy(&word, ptr + n, span.typesize - n);
+			h = cvector_algo_hash_mix(h, word);
+		}
+	}
+	h ^= h >> 29;
+	h *= 0x94d049bb133111ebULL;
+	return h ^ (h >> 32);
+}
@@ -0,0 +1,236 @@
+#ifndef CVECTOR_ALGO_H_INCLUDED
+#define CVECTOR_ALGO_H_INCLUDED
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+// algorithms on a raw item range
+// first                                  first + count * typesize
+// |                                      |
+// V                                      V
+// +--------------------------------------+
+// | item | item | ...            | item  |
+// +--------------------------------------+
+// items compare equal when all typesize bytes are equal
+
+/*   cvector_algo_find: first item equal val
+ *   first:    first item pointer
+ *   count:    item count
+ *   typesize: item size
+ *   val:      item pointer
+ *   return: item pointer, NULL if not found
+ */
+void*    cvector_algo_find(const void* first, uint64_t count, uint64_t typesize, const void* val);
+
+/*   cvector_algo_rfind: last item equal val
+ *   first:    first item pointer
+ *   count:    item count
+ *   typesize: item size
+ *   val:      item pointer
+ *   return: item pointer, NULL if not found
+ */
+void*    cvector_algo_rfind(const void* first, uint64_t count, uint64_t typesize, const void* val);
+
+/*   cvector_algo_count: count items equal val
+ *   first:    first item pointer
+ *   count:    item count
+ *   typesize: item size
+ *   val:      item pointer
+ *   return: item count equal val
+ */
+uint64_t cvector_algo_count(const void* first, uint64_t count, uint64_t typesize, const void* val);
+
+/*   cvector_algo_find_if: first item pred returns non zero
+ *   first:    first item pointer
+ *   count:    item count
+ *   typesize: item size
+ *   pred:     pred(item, arg)
+ *   arg:      pred user pointer
+ *   return: item pointer, NULL if not found
+ */
+void*    cvector_algo_find_if(const void* first, uint64_t count, uint64_t typesize,
+                              uint8_t (*pred)(const void* item, void* arg), void* arg);
+
+/*   cvector_algo_lower_bound: first item not less than val, items sorted by cmp
+ *   first:    first item pointer
+ *   count:    item count
+ *   typesize: item size
+ *   val:      item pointer
+ *   cmp:      cmp(item, val) < 0, == 0, > 0 as qsort
+ *   return: item pointer, first + count * typesize if every item is less
+ */
+void*    cvector_algo_lower_bound(const void* first, uint64_t count, uint64_t typesize, const void* val,
+                                  int (*cmp)(const void* a, const void* b));
+
+/*   cvector_algo_upper_bound: first item greater than val, items sorted by cmp
+ *   first:    first item pointer
+ *   count:    item count
+ *   typesize: item size
+ *   val:      item pointer
+ *   cmp:      cmp(item, val) < 0, == 0, > 0 as qsort
+ *   return: item pointer, first + count * typesize if no item is greater
+ */
+void*    cvector_algo_upper_bound(const void* first, uint64_t count, uint64_t typesize, const void* val,
+                                  int (*cmp)(const void* a, const void* b));
+
+/*   cvector_algo_sort: sort items in place, not stable
+ *   first:    first item pointer
+ *   count:    item count
+ *   typesize: item size
+ *   cmp:      cmp(a, b) < 0, == 0, > 0 as qsort
+ */
+void     cvector_algo_sort(void* first, uint64_t count, uint64_t typesize, int (*cmp)(const void* a, const void* b));
+
+/*   cvector_algo_reverse: reverse items in place
+ *   first:    first item pointer
+ *   count:    item count
+ *   typesize: item size
+ */
+void     cvector_algo_reverse(void* first, uint64_t count, uint64_t typesize);
+
+/*   cvector_algo_rotate: rotate items left, middle item becomes the first
+ *   first:    first item pointer
+ *   count:    item count
+ *   typesize: item size
+ *   middle:   middle item index, <= count
+ */
+void     cvector_algo_rotate(void* first, uint64_t count, uint64_t typesize, uint64_t middle);
+
+/*   cvector_algo_radix_sort: sort items by an unsigned integer key, stable
+ *   first:      first item pointer
+ *   count:      item count
+ *   typesize:   item size
+ *   key_offset: key byte offset in item
+ *   key_width:  key size, 1, 2, 4 or 8, native byte order
+ *   return: 0 if success, -1 if bad key or out of memory
+ */
+int      cvector_algo_radix_sort(void* first, uint64_t count, uint64_t typesize, uint64_t key_offset, uint64_t key_width);
+
+/*   cvector_algo_parallel_sort: sort items in place with threads, not stable
+ *   first:    first item pointer
+ *   count:    item count
+ *   typesize: item size
+ *   cmp:      cmp(a, b) < 0, == 0, > 0 as qsort
+ *   threads:  thread count, 0 for online cpu count
+ *   return: 0 if success, -1 if out of memory
+ */
+int      cvector_algo_parallel_sort(void* first, uint64_t count, uint64_t typesize,
+                                    int (*cmp)(const void* a, const void* b), uint64_t threads);
+
+// span, a view of count items stride bytes apart, it owns nothing
+// first          first + stride        first + 2 * stride
+// |              |                     |
+// V              V                     V
+// +------+-------+------+-------+------+-------+
+// | item |       | item |       | item |       |
+// +------+-------+------+-------+------+-------+
+// stride == typesize for a contiguous range, the span is valid while its items stay
+struct cvector_span_t {
+    void*     first;
+    uint64_t  count;
+    uint64_t  typesize;
+    uint64_t  stride;
+};
+
+typedef struct cvector_span_t cvector_span;
+
+/*   cvector_span_make: span of a contiguous range
+ *   first:    first item pointer
+ *   count:    item count
+ *   typesize: item size
+ *   return: span
+ */
+static inline cvector_span  cvector_span_make(void* first, uint64_t count, uint64_t typesize) {
+    cvector_span span;
+    span.first    = (count > 0) ? first : NULL;
+    span.count    = (first != NULL) ? count : 0;
+    span.typesize = typesize;
+    span.stride   = typesize;
+    return span;
+}
+
+/*   cvector_span_at: index item pointer
+ *   span:  span
+ *   index: item index
+ *   return: item pointer, NULL if index >= count
+ */
+static inline void*         cvector_span_at(cvector_span span, uint64_t index) {
+    if (index >= span.count)
+        return NULL;
+    return (uint8_t*) span.first + index * span.stride;
+}
+
+/*   cvector_span_sub: span of count items from index
+ *   span:  span
+ *   index: first item index
+ *   count: item count, cut at the span end
+ *   return: span
+ */
+static inline cvector_span  cvector_span_sub(cvector_span span, uint64_t index, uint64_t count) {
+    if (index > span.count)
+        index = span.count;
+    if (count > span.count - index)
+        count = span.count - index;
+    span.first = (count > 0) ? (uint8_t*) span.first + index * span.stride : NULL;
+    span.count = count;
+    return span;
+}
+
+/*   cvector_span_step: span of every step-th item, from the first
+ *   span: span
+ *   step: item step > 0
+ *   return: span
+ */
+static inline cvector_span  cvector_span_step(cvector_span span, uint64_t step) {
+    if (step <= 1)
+        return span;
+    span.count  = (span.count + step - 1) / step;
+    span.stride = span.stride * step;
+    return span;
+}
+
+/*   cvector_span_find: first item equal val
+ *   span: span
+ *   val:  item pointer
+ *   return: item pointer, NULL if not found
+ */
+void*    cvector_span_find(cvector_span span, const void* val);
+
+/*   cvector_span_count: count items equal val
+ *   span: span
+ *   val:  item pointer
+ *   return: item count equal val
+ */
+uint64_t cvector_span_count(cvector_span span, const void* val);
+
+/*   cvector_span_sort: sort items in place, not stable
+ *   span: span
+ *   cmp:  cmp(a, b) < 0, == 0, > 0 as qsort
+ */
+void     cvector_span_sort(cvector_span span, int (*cmp)(const void* a, const void* b));
+
+/*   cvector_span_equal: item count and items equal
+ *   a:    span
+ *   b:    span
+ *   return: 1 if equal
+ */
+uint8_t  cvector_span_equal(cvector_span a, cvector_span b);
+
+/*   cvector_span_hash: 64 bit hash of the item bytes, equal spans hash equal whatever the stride
+ *   span: span
+ *   return: hash
+ */
+uint64_t cvector_span_hash(cvector_span span);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,769 @@
+#include  <stddef.h>
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  <time.h>
+#include  <pthread.h>
+#include  <unistd.h>
+
+#include  "cvector.h"
+#include  "csegvector.h"
+#include  "cconcvector.h"
+#include  "csoavector.h"
+#include  "cbitvector.h"
+#include  "cvector_io.h"
+
+#define BENCH_COUNT   (1000000)
+#define BENCH_ROUNDS  (100)
+
+static double bench_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// per-item shifting, as cvector did before the range layer
+static void bench_naive_erase(void **last, void *position, uint64_t typesize) {
+    void *next = position + typesize;
+    for (; next < *last; position += typesize, next += typesize)
+        memcpy(position, next, typesize);
+    *last = position;
+}
+
+static void bench_naive_fill(void **last, void *position, uint64_t n, const void *val, uint64_t typesize) {
+    uint64_t newsize = n * typesize, step;
+    void *ptr = *last - typesize;
+    for (; ptr >= position; ptr -= typesize)
+        memcpy(ptr + newsize, ptr, typesize);
+    for (step = 0; step < newsize; step += typesize)
+        memcpy(position + step, val, typesize);
+    *last += newsize;
+}
+
+static void bench_typesize(uint64_t typesize) {
+    uint8_t  val[64];
+    uint64_t i;
+    double   start, naive_erase, naive_fill, range_erase, range_fill;
+    void    *first, *last;
+    cvector *vec = NULL;
+
+    memset(val, 0x5a, sizeof(val));
+    first = malloc((BENCH_COUNT + BENCH_ROUNDS) * typesize);
+    memset(first, 0x11, BENCH_COUNT * typesize);
+    last  = first + BENCH_COUNT * typesize;
+
+    start = bench_now();
+    for (i = 0; i < BENCH_ROUNDS; ++i)
+        bench_naive_erase(&last, first + (BENCH_COUNT / 2) * typesize, typesize);
+    naive_erase = bench_now() - start;
+
+    start = bench_now();
+    for (i = 0; i < BENCH_ROUNDS; ++i)
+        bench_naive_fill(&last, first + (BENCH_COUNT / 2) * typesize, 1, val, typesize);
+    naive_fill = bench_now() - start;
+    free(first);
+
+    vec = cvector_alloc(BENCH_COUNT + BENCH_ROUNDS, typesize);
+    vec->fill(vec, vec->begin(vec), BENCH_COUNT, val);
+
+    start = bench_now();
+    for (i = 0; i < BENCH_ROUNDS; ++i)
+        vec->remove(vec, vec->at(vec, BENCH_COUNT / 2));
+    range_erase = bench_now() - start;
+
+    start = bench_now();
+    for (i = 0; i < BENCH_ROUNDS; ++i)
+        vec->fill(vec, vec->at(vec, BENCH_COUNT / 2), 1, val);
+    range_fill = bench_now() - start;
+    vec->free(vec);
+
+    printf("typesize %2llu  erase: %8.3f ms -> %8.3f ms  fill: %8.3f ms -> %8.3f ms\n",
+           (unsigned long long) typesize,
+           naive_erase * 1e3, range_erase * 1e3, naive_fill * 1e3, range_fill * 1e3);
+}
+
+static void bench_append(uint64_t typesize) {
+    uint8_t  val[64];
+    uint64_t i;
+    double   start, push_back, fill;
+    cvector *vec = cvector_alloc(16, typesize);
+
+    memset(val, 0x5a, sizeof(val));
+    start = bench_now();
+    for (i = 0; i < BENCH_COUNT; ++i)
+        vec->push_back(vec, val);
+    push_back = bench_now() - start;
+
+    vec->clear(vec);
+    start = bench_now();
+    for (i = 0; i < BENCH_ROUNDS; ++i) {
+        vec->clear(vec);
+        vec->fill(vec, vec->end(vec), BENCH_COUNT, val);
+    }
+    fill = bench_now() - start;
+    vec->free(vec);
+
+    printf("typesize %2llu  push_back: %6.2f ns/item  fill: %6.2f ns/item\n",
+           (unsigned long long) typesize,
+           push_back * 1e9 / BENCH_COUNT, fill * 1e9 / BENCH_COUNT / BENCH_ROUNDS);
+}
+
+static void bench_access() {
+    uint64_t i, n, sum = 0;
+    double   start, vtable, fast;
+    cvector *vec = cvector_alloc(BENCH_COUNT, sizeof(uint64_t));
+
+    for (i = 0; i < BENCH_COUNT; ++i)
+        vec->push_back(vec, &i);
+
+    start = bench_now();
+    for (n = 0; n < BENCH_ROUNDS; ++n)
+        for (i = 0; i < vec->size(vec); ++i)
+            sum += *((uint64_t*) vec->at(vec, i));
+    vtable = bench_now() - start;
+
+    start = bench_now();
+    for (n = 0; n < BENCH_ROUNDS; ++n)
+        for (i = 0; i < cvector_fast_size(vec); ++i)
+            sum += *((uint64_t*) cvector_fast_at(vec, i));
+    fast = bench_now() - start;
+    vec->free(vec);
+
+    printf("size/at scan: %6.2f ns/item -> %6.2f ns/item (%llu)\n",
+           vtable * 1e9 / BENCH_COUNT / BENCH_ROUNDS, fast * 1e9 / BENCH_COUNT / BENCH_ROUNDS,
+           (unsigned long long) (sum & 1));
+}
+
+static void bench_find(uint64_t typesize) {
+    uint8_t  val[8];
+    uint64_t i, hits = 0;
+    double   start, loop, find;
+    void    *it;
+    cvector *vec = cvector_alloc(BENCH_COUNT, typesize);
+
+    memset(val, 0x5a, sizeof(val));
+    it = vec->append_uninitialized(vec, BENCH_COUNT);
+    memset(it, 0x11, BENCH_COUNT * typesize);
+
+    // miss: every item is compared
+    start = bench_now();
+    for (i = 0; i < BENCH_ROUNDS; ++i) {
+        for (it = vec->begin(vec); it < vec->end(vec); it += typesize) {
+            if (memcmp(it, val, typesize) == 0)
+                break;
+        }
+        hits += (it < vec->end(vec));
+    }
+    loop = bench_now() - start;
+
+    start = bench_now();
+    for (i = 0; i < BENCH_ROUNDS; ++i)
+        hits += (vec->find(vec, val) != NULL);
+    find = bench_now() - start;
+    vec->free(vec);
+
+    printf("typesize %2llu  memcmp loop: %8.3f ms -> find: %8.3f ms (%llu)\n",
+           (unsigned long long) typesize, loop * 1e3, find * 1e3, (unsigned long long) hits);
+}
+
+#define BENCH_SORT_COUNT  (10000000)
+
+static int bench_compare(const void *a, const void *b) {
+    uint32_t x = *((const uint32_t*) a), y = *((const uint32_t*) b);
+    return (x > y) - (x < y);
+}
+
+static void bench_sort() {
+    uint64_t i, seed = 88172645463325252ULL;
+    double   start, libc, sort, radix;
+    uint32_t *keys;
+    cvector *vec  = cvector_alloc(BENCH_SORT_COUNT, sizeof(uint32_t));
+    cvector *copy = cvector_alloc(BENCH_SORT_COUNT, sizeof(uint32_t));
+
+    keys = vec->append_uninitialized(vec, BENCH_SORT_COUNT);
+    for (i = 0; i < BENCH_SORT_COUNT; ++i) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        keys[i] = (uint32_t) seed;
+    }
+
+    vec->copy(vec, copy);
+    start = bench_now();
+    qsort(copy->data(copy), BENCH_SORT_COUNT, sizeof(uint32_t), bench_compare);
+    libc = bench_now() - start;
+
+    vec->copy(vec, copy);
+    start = bench_now();
+    copy->sort(copy, bench_compare);
+    sort = bench_now() - start;
+
+    vec->copy(vec, copy);
+    start = bench_now();
+    copy->radix_sort(copy, 0, sizeof(uint32_t));
+    radix = bench_now() - start;
+
+    printf("%d random uint32  qsort: %8.1f ms  sort: %8.1f ms  radix_sort: %8.1f ms\n",
+           BENCH_SORT_COUNT, libc * 1e3, sort * 1e3, radix * 1e3);
+
+    for (i = 1; i <= 16; i *= 2) {
+        vec->copy(vec, copy);
+        start = bench_now();
+        copy->parallel_sort(copy, bench_compare, i);
+        printf("parallel_sort %2llu threads: %8.1f ms\n", (unsigned long long) i, (bench_now() - start) * 1e3);
+    }
+    vec->free(vec);
+    copy->free(copy);
+}
+
+static void bench_bound() {
+    uint64_t i, hits = 0;
+    uint32_t key, *keys;
+    double   start, libc, bound;
+    cvector *vec = cvector_alloc(BENCH_COUNT, sizeof(uint32_t));
+
+    keys = vec->append_uninitialized(vec, BENCH_COUNT);
+    for (i = 0; i < BENCH_COUNT; ++i)
+        keys[i] = (uint32_t) (i * 2);
+
+    start = bench_now();
+    for (i = 0; i < BENCH_COUNT; ++i) {
+        key = (uint32_t) ((i * 2654435761ULL) % (2 * BENCH_COUNT));
+        hits += (bsearch(&key, vec->data(vec), BENCH_COUNT, sizeof(uint32_t), bench_compare) != NULL);
+    }
+    libc = bench_now() - start;
+
+    start = bench_now();
+    for (i = 0; i < BENCH_COUNT; ++i) {
+        key = (uint32_t) ((i * 2654435761ULL) % (2 * BENCH_COUNT));
+        hits += (vec->lower_bound(vec, &key, bench_compare) != vec->end(vec));
+    }
+    bound = bench_now() - start;
+    vec->free(vec);
+
+    printf("%d lookups in %d sorted uint32  bsearch: %6.1f ns  lower_bound: %6.1f ns (%llu)\n",
+           BENCH_COUNT, BENCH_COUNT, libc * 1e9 / BENCH_COUNT, bound * 1e9 / BENCH_COUNT,
+           (unsigned long long) (hits & 1));
+}
+
+static void bench_inline() {
+    uint64_t i, j;
+    double   start, heap, inlined;
+    cvector *vec;
+
+    start = bench_now();
+    for (i = 0; i < BENCH_COUNT; ++i) {
+        vec = cvector_alloc(8, sizeof(uint64_t));
+        for (j = 0; j < 4; ++j)
+            vec->push_back(vec, &j);
+        vec->free(vec);
+    }
+    heap = bench_now() - start;
+
+    start = bench_now();
+    for (i = 0; i < BENCH_COUNT; ++i) {
+        vec = cvector_alloc_inline(1, sizeof(uint64_t), 8);
+        for (j = 0; j < 4; ++j)
+            vec->push_back(vec, &j);
+        vec->free(vec);
+    }
+    inlined = bench_now() - start;
+
+    printf("alloc, 4 push_back, free  cvector_alloc: %6.1f ns  cvector_alloc_inline: %6.1f ns\n",
+           heap * 1e9 / BENCH_COUNT, inlined * 1e9 / BENCH_COUNT);
+}
+
+#define BENCH_WINDOW  (10000)
+
+static double bench_sliding(cvector *vec) {
+    uint64_t i;
+    double   start;
+    for (i = 0; i < BENCH_WINDOW; ++i)
+        vec->push_back(vec, &i);
+    start = bench_now();
+    for (i = 0; i < BENCH_COUNT / 10; ++i) {
+        vec->push_back(vec, &i);
+        vec->pop_front(vec);
+    }
+    return bench_now() - start;
+}
+
+static double bench_front(cvector *vec) {
+    uint64_t i;
+    double   start = bench_now();
+    for (i = 0; i < BENCH_COUNT / 10; ++i)
+        vec->push_front(vec, &i);
+    return bench_now() - start;
+}
+
+static void bench_slack() {
+    double   plain, slack;
+    cvector *vec, *vec_slack;
+
+    vec       = cvector_alloc(16, sizeof(uint64_t));
+    vec_slack = cvector_alloc_slack(16, sizeof(uint64_t));
+    plain = bench_sliding(vec);
+    slack = bench_sliding(vec_slack);
+    printf("%d item window, push_back + pop_front  cvector_alloc: %8.1f ns  cvector_alloc_slack: %6.1f ns\n",
+           BENCH_WINDOW, plain * 1e9 / (BENCH_COUNT / 10), slack * 1e9 / (BENCH_COUNT / 10));
+    vec->clear(vec);
+    vec_slack->clear(vec_slack);
+    plain = bench_front(vec);
+    slack = bench_front(vec_slack);
+    printf("%d push_front  cvector_alloc: %8.1f ns  cvector_alloc_slack: %6.1f ns\n",
+           BENCH_COUNT / 10, plain * 1e9 / (BENCH_COUNT / 10), slack * 1e9 / (BENCH_COUNT / 10));
+    vec->free(vec);
+    vec_slack->free(vec_slack);
+}
+
+#define BENCH_SEGMENT_COUNT  (20000000)
+
+static void bench_segvector() {
+    uint64_t i, sum = 0;
+    double   start, now, last, worst, worst_seg, total, total_seg, scan, scan_seg;
+    cvector    *vec = cvector_alloc(16, sizeof(uint64_t));
+    csegvector *seg = csegvector_alloc(16, sizeof(uint64_t));
+
+    // worst single push_back, cvector copies everything when it grows
+    worst = 0;
+    start = last = bench_now();
+    for (i = 0; i < BENCH_SEGMENT_COUNT; ++i) {
+        vec->push_back(vec, &i);
+        if ((i & (i - 1)) == 0 || (i & 1023) == 0) {
+            now = bench_now();
+            if (now - last > worst)
+                worst = now - last;
+            last = now;
+        }
+    }
+    total = bench_now() - start;
+
+    worst_seg = 0;
+    start = last = bench_now();
+    for (i = 0; i < BENCH_SEGMENT_COUNT; ++i) {
+        seg->push_back(seg, &i);
+        if ((i & (i - 1)) == 0 || (i & 1023) == 0) {
+            now = bench_now();
+            if (now - last > worst_seg)
+                worst_seg = now - last;
+            last = now;
+        }
+    }
+    total_seg = bench_now() - start;
+
+    start = bench_now();
+    for (i = 0; i < BENCH_SEGMENT_COUNT; ++i)
+        sum += *((uint64_t*) vec->at(vec, i));
+    scan = bench_now() - start;
+    start = bench_now();
+    for (i = 0; i < BENCH_SEGMENT_COUNT; ++i)
+        sum += *((uint64_t*) seg->at(seg, i));
+    scan_seg = bench_now() - start;
+    vec->free(vec);
+    seg->free(seg);
+
+    printf("%d push_back  cvector: %6.1f ms, worst gap %7.2f ms  csegvector: %6.1f ms, worst gap %7.2f ms\n",
+           BENCH_SEGMENT_COUNT, total * 1e3, worst * 1e3, total_seg * 1e3, worst_seg * 1e3);
+    printf("%d at  cvector: %5.2f ns/item  csegvector: %5.2f ns/item (%llu)\n",
+           BENCH_SEGMENT_COUNT, scan * 1e9 / BENCH_SEGMENT_COUNT, scan_seg * 1e9 / BENCH_SEGMENT_COUNT,
+           (unsigned long long) (sum & 1));
+}
+
+static double bench_worst_push(cvector *vec, double *total) {
+    uint64_t i;
+    double   start, now, last, worst = 0;
+    start = last = bench_now();
+    for (i = 0; i < BENCH_SEGMENT_COUNT; ++i) {
+        vec->push_back(vec, &i);
+        if ((i & (i - 1)) == 0 || (i & 1023) == 0) {
+            now = bench_now();
+            if (now - last > worst)
+                worst = now - last;
+            last = now;
+        }
+    }
+    *total = bench_now() - start;
+    return worst;
+}
+
+static void bench_incremental() {
+    double   worst, worst_inc, total, total_inc;
+    cvector *vec = cvector_alloc_growth(16, sizeof(uint64_t), CVECTOR_GROWTH_FACTOR, 200);
+    cvector *inc = cvector_alloc_incremental(16, sizeof(uint64_t), 4);
+    worst     = bench_worst_push(vec, &total);
+    worst_inc = bench_worst_push(inc, &total_inc);
+    vec->free(vec);
+    inc->free(inc);
+    printf("%d push_back  cvector_alloc: %6.1f ms, worst gap %7.2f ms  cvector_alloc_incremental: %6.1f ms, worst gap %7.2f ms\n",
+           BENCH_SEGMENT_COUNT, total * 1e3, worst * 1e3, total_inc * 1e3, worst_inc * 1e3);
+}
+
+#define BENCH_CONCURRENT_COUNT  (4000000)
+
+struct bench_writer_t {
+    cvector         *vec;
+    cconcvector     *conc;
+    pthread_mutex_t *lock;
+    uint64_t         count;
+};
+
+static void* bench_locked_writer(void *arg) {
+    struct bench_writer_t *writer = (struct bench_writer_t*) arg;
+    uint64_t i;
+    for (i = 0; i < writer->count; ++i) {
+        pthread_mutex_lock(writer->lock);
+        writer->vec->push_back(writer->vec, &i);
+        pthread_mutex_unlock(writer->lock);
+    }
+    return NULL;
+}
+
+static void* bench_concurrent_writer(void *arg) {
+    struct bench_writer_t *writer = (struct bench_writer_t*) arg;
+    uint64_t i;
+    for (i = 0; i < writer->count; ++i)
+        writer->conc->push_back(writer->conc, &i);
+    return NULL;
+}
+
+static double bench_writers(uint64_t threads, void* (*fn)(void*), struct bench_writer_t *writer) {
+    pthread_t tid[64];
+    uint64_t i;
+    double   start = bench_now();
+    writer->count = BENCH_CONCURRENT_COUNT / threads;
+    for (i = 0; i < threads; ++i)
+        pthread_create(&tid[i], NULL, fn, writer);
+    for (i = 0; i < threads; ++i)
+        pthread_join(tid[i], NULL);
+    return bench_now() - start;
+}
+
+static void bench_concurrent() {
+    uint64_t threads;
+    double   locked, conc;
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    struct bench_writer_t writer;
+
+    printf("%d push_back shared by threads, mutex + cvector -> cconcvector\n", BENCH_CONCURRENT_COUNT);
+    for (threads = 1; threads <= 64; threads *= 2) {
+        writer.lock = &lock;
+        writer.vec  = cvector_alloc(16, sizeof(uint64_t));
+        writer.conc = cconcvector_alloc(16, sizeof(uint64_t));
+        locked = bench_writers(threads, bench_locked_writer, &writer);
+        conc   = bench_writers(threads, bench_concurrent_writer, &writer);
+        printf("%2llu threads: %8.1f ms -> %8.1f ms (%llu)\n", (unsigned long long) threads,
+               locked * 1e3, conc * 1e3, (unsigned long long) writer.conc->size(writer.conc));
+        writer.vec->free(writer.vec);
+        writer.conc->free(writer.conc);
+    }
+}
+
+#define BENCH_SNAPSHOTS  (1000)
+
+// readers take a consistent view while the writer keeps appending
+static void bench_snapshot() {
+    uint64_t i, j, sum = 0;
+    double   start, copy, snapshot;
+    cvector *vec = cvector_alloc(BENCH_COUNT, sizeof(uint64_t));
+    cvector *view;
+    for (i = 0; i < BENCH_COUNT; ++i)
+        vec->push_back(vec, &i);
+
+    start = bench_now();
+    for (i = 0; i < BENCH_SNAPSHOTS; ++i) {
+        view = cvector_alloc(BENCH_COUNT, sizeof(uint64_t));
+        vec->copy(vec, view);
+        sum += *((uint64_t*) view->back(view));
+        view->free(view);
+        for (j = 0; j < 10; ++j)
+            vec->push_back(vec, &j);
+    }
+    copy = bench_now() - start;
+
+    start = bench_now();
+    for (i = 0; i < BENCH_SNAPSHOTS; ++i) {
+        view = vec->snapshot(vec);
+        sum += *((uint64_t*) view->back(view));
+        view->free(view);
+        for (j = 0; j < 10; ++j)
+            vec->push_back(vec, &j);
+    }
+    snapshot = bench_now() - start;
+
+    printf("%d item view, read, free, 10 push_back  copy: %8.1f us  snapshot: %6.1f us (%llu)\n",
+           BENCH_COUNT, copy * 1e6 / BENCH_SNAPSHOTS, snapshot * 1e6 / BENCH_SNAPSHOTS,
+           (unsigned long long) (sum & 1));
+    vec->free(vec);
+}
+
+struct bench_record_t {
+    uint64_t  key;
+    uint8_t   payload[56];
+};
+
+// sum one 8 byte field of 64 byte records
+static void bench_soavector() {
+    uint64_t i, j, sum = 0, *keys;
+    uint64_t offsets[] = {offsetof(struct bench_record_t, key), offsetof(struct bench_record_t, payload)};
+    uint64_t widths[]  = {sizeof(uint64_t), 56};
+    double   start, rows, column;
+    struct bench_record_t record;
+    cvector    *vec = cvector_alloc(BENCH_COUNT, sizeof(struct bench_record_t));
+    csoavector *soa = csoavector_alloc(BENCH_COUNT, sizeof(struct bench_record_t), 2, offsets, widths);
+    memset(&record, 0, sizeof(record));
+    for (i = 0; i < BENCH_COUNT; ++i) {
+        record.key = i;
+        vec->push_back(vec, &record);
+        soa->push_back(soa, &record);
+    }
+
+    start = bench_now();
+    for (j = 0; j < 10; ++j) {
+        for (i = 0; i < BENCH_COUNT; ++i)
+            sum += ((struct bench_record_t*) cvector_fast_at(vec, i))->key;
+    }
+    rows = bench_now() - start;
+
+    start = bench_now();
+    for (j = 0; j < 10; ++j) {
+        keys = soa->column(soa, 0);
+        for (i = 0; i < BENCH_COUNT; ++i)
+            sum += keys[i];
+    }
+    column = bench_now() - start;
+
+    printf("%d records of 64 bytes, sum one field  cvector: %6.2f ms  csoavector column: %6.2f ms (%llu)\n",
+           BENCH_COUNT, rows * 1e3 / 10, column * 1e3 / 10, (unsigned long long) (sum & 1));
+    vec->free(vec);
+    soa->free(soa);
+}
+
+#define BENCH_BITS  (16 * BENCH_COUNT)
+
+// flags as one byte items against packed bits
+static void bench_bitvector() {
+    uint64_t i, j, count = 0;
+    uint8_t  flag;
+    double   start, bytes, bits;
+    cvector    *vec = cvector_alloc(BENCH_BITS, sizeof(uint8_t));
+    cbitvector *bit = cbitvector_alloc(BENCH_BITS);
+    for (i = 0; i < BENCH_BITS; ++i) {
+        flag = (i % 3) == 0;
+        cvector_fast_push_back(vec, &flag);
+        bit->push_back(bit, flag);
+    }
+    flag = 1;
+
+    start = bench_now();
+    for (j = 0; j < 10; ++j)
+        count += vec->count(vec, &flag);
+    bytes = bench_now() - start;
+
+    start = bench_now();
+    for (j = 0; j < 10; ++j)
+        count += bit->popcount(bit);
+    bits = bench_now() - start;
+
+    printf("%d flags, count set  cvector uint8_t: %6.2f ms (%llu KB)  cbitvector popcount: %6.2f ms (%llu KB) (%llu)\n",
+           BENCH_BITS, bytes * 1e3 / 10, (unsigned long long) (vec->capacity(vec) >> 10),
+           bits * 1e3 / 10, (unsigned long long) (bit->capacity(bit) >> 13), (unsigned long long) (count & 1));
+    vec->free(vec);
+    bit->free(bit);
+}
+
+// look up a missing item in a middle slice, copied out or viewed in place
+static void bench_span() {
+    uint64_t i, hits = 0, missing = BENCH_COUNT;
+    double   start, copy, span;
+    cvector *vec = cvector_alloc(BENCH_COUNT, sizeof(uint64_t));
+    cvector *slice;
+    for (i = 0; i < BENCH_COUNT; ++i)
+        vec->push_back(vec, &i);
+
+    start = bench_now();
+    for (i = 0; i < BENCH_ROUNDS; ++i) {
+        slice = cvector_alloc(BENCH_COUNT / 2, sizeof(uint64_t));
+        slice->assign(slice, vec->at(vec, BENCH_COUNT / 4), vec->at(vec, BENCH_COUNT / 4 * 3));
+        hits += slice->find(slice, &missing) != NULL;
+        slice->free(slice);
+    }
+    copy = bench_now() - start;
+
+    start = bench_now();
+    for (i = 0; i < BENCH_ROUNDS; ++i)
+        hits += cvector_span_find(vec->span(vec, vec->at(vec, BENCH_COUNT / 4), vec->at(vec, BENCH_COUNT / 4 * 3)), &missing) != NULL;
+    span = bench_now() - start;
+
+    printf("%d item slice, find  assign + find: %6.1f us  span find: %6.1f us (%llu)\n",
+           BENCH_COUNT / 2, copy * 1e6 / BENCH_ROUNDS, span * 1e6 / BENCH_ROUNDS, (unsigned long long) hits);
+    vec->free(vec);
+}
+
+// reverse and rotate against the per-item swap and erase + insert they replace
+static void bench_reverse(uint64_t typesize) {
+    uint8_t  val[64], *item, *first, *last;
+    uint64_t i, j;
+    double   start, naive, reverse, shift, rotate;
+    cvector *vec = cvector_alloc(BENCH_COUNT, typesize);
+    memset(val, 0, sizeof(val));
+    for (i = 0; i < BENCH_COUNT; ++i) {
+        val[0] = (uint8_t) i;
+        vec->push_back(vec, val);
+    }
+
+    // the old generic reverse, three memcpy per item through a heap temp
+    start = bench_now();
+    for (j = 0; j < 10; ++j) {
+        item  = malloc(typesize);
+        first = vec->begin(vec);
+        last  = vec->end(vec) - typesize;
+        for (; first < last; first += typesize, last -= typesize) {
+            memcpy(item,  first, typesize);
+            memcpy(first, last,  typesize);
+            memcpy(last,  item,  typesize);
+        }
+        free(item);
+    }
+    naive = bench_now() - start;
+
+    start = bench_now();
+    for (j = 0; j < 10; ++j)
+        vec->reverse(vec);
+    reverse = bench_now() - start;
+
+    // rotate by a third, erase + insert copies the head out and back
+    start = bench_now();
+    for (j = 0; j < 10; ++j) {
+        item = malloc(BENCH_COUNT / 3 * typesize);
+        memcpy(item, vec->begin(vec), BENCH_COUNT / 3 * typesize);
+        vec->erase(vec, vec->begin(vec), vec->at(vec, BENCH_COUNT / 3));
+        vec->insert(vec, vec->end(vec), item, item + BENCH_COUNT / 3 * typesize);
+        free(item);
+    }
+    shift = bench_now() - start;
+
+    start = bench_now();
+    for (j = 0; j < 10; ++j)
+        vec->rotate(vec, vec->at(vec, BENCH_COUNT / 3));
+    rotate = bench_now() - start;
+
+    printf("typesize %2llu  reverse %6.2f ms -> %6.2f ms  rotate erase + insert %6.2f ms -> %6.2f ms\n",
+           (unsigned long long) typesize, naive * 1e3 / 10, reverse * 1e3 / 10, shift * 1e3 / 10, rotate * 1e3 / 10);
+    vec->free(vec);
+}
+
+static void bench_move() {
+    uint64_t i, items = 0, size, capacity;
+    double   start, copy, move, release;
+    cvector *vec = cvector_alloc(BENCH_COUNT, sizeof(uint64_t)), *next;
+    void    *ptr;
+    for (i = 0; i < BENCH_COUNT; ++i)
+        vec->push_back(vec, &i);
+
+    // hand the items to the next stage and back
+    start = bench_now();
+    for (i = 0; i < BENCH_ROUNDS; ++i) {
+        next = cvector_alloc(BENCH_COUNT, sizeof(uint64_t));
+        vec->copy(vec, next);
+        vec->free(vec);
+        vec = next;
+    }
+    copy = bench_now() - start;
+
+    start = bench_now();
+    for (i = 0; i < BENCH_ROUNDS; ++i) {
+        next = cvector_alloc(1, sizeof(uint64_t));
+        next->move_into(next, vec);
+        vec->free(vec);
+        vec = next;
+    }
+    move = bench_now() - start;
+
+    start = bench_now();
+    for (i = 0; i < BENCH_ROUNDS; ++i) {
+        size     = vec->size(vec);
+        capacity = vec->capacity(vec);
+        ptr = cvector_release(vec);
+        vec = cvector_adopt(ptr, size, capacity, sizeof(uint64_t));
+    }
+    release = bench_now() - start;
+    items = vec->size(vec);
+
+    printf("%d items handed over  copy + free: %8.1f us  move_into: %6.2f us  release + adopt: %6.2f us (%llu)\n",
+           BENCH_COUNT, copy * 1e6 / BENCH_ROUNDS, move * 1e6 / BENCH_ROUNDS, release * 1e6 / BENCH_ROUNDS, (unsigned long long) items);
+    vec->free(vec);
+}
+
+static void bench_io(uint16_t flags) {
+    char path[] = "/tmp/cvector_benchXXXXXX";
+    int fd = mkstemp(path);
+    uint64_t i, items = 0;
+    double   start, naive, save, load;
+    cvector *vec = cvector_alloc(BENCH_COUNT, sizeof(uint64_t)), *copy;
+    unlink(path);
+    for (i = 0; i < BENCH_COUNT; ++i)
+        vec->push_back(vec, &i);
+
+    // per-item write and read, push_back on load
+    start = bench_now();
+    for (i = 0; i < BENCH_COUNT; ++i)
+        write(fd, vec->at(vec, i), sizeof(uint64_t));
+    lseek(fd, 0, SEEK_SET);
+    copy = cvector_alloc(1, sizeof(uint64_t));
+    while (read(fd, &i, sizeof(uint64_t)) == sizeof(uint64_t))
+        copy->push_back(copy, &i);
+    naive = bench_now() - start;
+    items += copy->size(copy);
+    copy->free(copy);
+
+    ftruncate(fd, 0);
+    lseek(fd, 0, SEEK_SET);
+    start = bench_now();
+    cvector_save(vec, fd, flags);
+    save = bench_now() - start;
+    lseek(fd, 0, SEEK_SET);
+    start = bench_now();
+    copy = cvector_load(fd);
+    load = bench_now() - start;
+    items += copy->size(copy);
+    copy->free(copy);
+
+    printf("%d items, crc %d  per-item io: %8.2f ms  save: %6.2f ms  load: %6.2f ms (%llu)\n",
+           BENCH_COUNT, flags & CVECTOR_IO_CRC, naive * 1e3, save * 1e3, load * 1e3, (unsigned long long) items);
+    close(fd);
+    vec->free(vec);
+}
+
+int main(int argc, const char *argv[]) {
+    uint64_t sizes[] = {1, 2, 4, 8, 16, 32};
+    uint64_t i;
+    printf("%d items, %d middle operations, per-item loop -> cvector\n", BENCH_COUNT, BENCH_ROUNDS);
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+        bench_typesize(sizes[i]);
+    printf("%d items appended\n", BENCH_COUNT);
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+        bench_append(sizes[i]);
+    bench_access();
+    printf("%d items, %d missing lookups\n", BENCH_COUNT, BENCH_ROUNDS);
+    for (i = 0; i < 4; ++i)
+        bench_find(sizes[i]);
+    bench_sort();
+    bench_bound();
+    bench_inline();
+    bench_slack();
+    bench_segvector();
+    bench_incremental();
+    bench_concurrent();
+    bench_snapshot();
+    bench_soavector();
+    bench_bitvector();
+    bench_span();
+    printf("%d items, per-item swap -> reverse, erase + insert -> rotate\n", BENCH_COUNT);
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+        bench_reverse(sizes[i]);
+    bench_io(0);
+    bench_io(CVECTOR_IO_CRC);
+    bench_move();
+    return 0;
+}
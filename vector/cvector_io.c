@@ -0,0 +1,381 @@
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CVECTOR_IO_X86  1
+#endif
+#include "cvector_io.h"
+
+// load reads this many bytes into the vector per read call
+#define CVECTOR_IO_CHUNK  (1 << 20)
+
+struct cvector_writer_data_t {
+	cvector_writer             writer;
+    int                        fd;
+    off_t                      offset;
+    uint64_t                   typesize;
+    uint64_t                   count;
+    uint32_t                   crc;
+    uint16_t                   flags;
+    uint8_t                    failed;
+};
+
+typedef struct cvector_writer_data_t  cvector_writer_data;
+
+
+/*   crc32c tables and kernels, reflected polynomial 0x82f63b78
+ */
+static    uint32_t    cvector_crc32c_table[256];
+
+static    uint32_t    cvector_crc32c_scalar(uint32_t crc, const uint8_t* ptr, uint64_t size) {
+	uint64_t i;
+	for (i = 0; i < size; ++i)
+		crc = cvector_crc32c_table[(crc ^ ptr[i]) & 0xff] ^ (crc >> 8);
+	return crc;
+}
+
+#ifdef CVECTOR_IO_X86
+static __attribute__((target("sse4.2"))) uint32_t    cvector_crc32c_sse42(uint32_t crc, const uint8_t* ptr, uint64_t size) {
+	uint64_t word, value = crc;
+	for (; size >= 8; ptr += 8, size -= 8) {
+		memcpy(&word, ptr, 8);
+		value = _mm_crc32_u64(value, word);
+	}
+	crc = (uint32_t) value;
+	for (; size > 0; ++ptr, --size)
+		crc = _mm_crc32_u8(crc, *ptr);
+	return crc;
+}
+#endif
+
+static    uint32_t    (*cvector_crc32c_chosen)(uint32_t crc, const uint8_t* ptr, uint64_t size) = NULL;
+
+static    pthread_once_t    cvector_crc32c_once = PTHREAD_ONCE_INIT;
+
+/*   crc32c_init: fill the table and choose the kernel by cpu, run once
+ */
+static    void    cvector_crc32c_init() {
+	uint32_t i, j, crc;
+	for (i = 0; i < 256; ++i) {
+		for (crc = i, j = 0; j < 8; ++j)
+			crc = (crc >> 1) ^ ((crc & 1) ? 0x82f63b78 : 0);
+		cvector_crc32c_table[i] = crc;
+	}
+	cvector_crc32c_chosen = cvector_crc32c_scalar;
+#ifdef CVECTOR_IO_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse4.2"))
+		cvector_crc32c_chosen = cvector_crc32c_sse42;
+#endif
+}
+
+/*   crc32c_kernel: crc kernel, table and kernel set up once, pthread_once orders them for every caller
+ *   return kernel pointer
+ */
+static    uint32_t    (*cvector_crc32c_kernel())(uint32_t crc, const uint8_t* ptr, uint64_t size) {
+	pthread_once(&cvector_crc32c_once, cvector_crc32c_init);
+	return cvector_crc32c_chosen;
+}
+
+/*   cvector_crc32c: crc32c (castagnoli) of size bytes
+ *   crc:  crc of the bytes before, 0 to start
+ *   data: bytes
+ *   size: byte count
+ *   return: crc
+ */
+uint32_t cvector_crc32c(uint32_t crc, const void* data, uint64_t size) {
+	if ((data == NULL) || (size <= 0))
+		return crc;
+	return ~cvector_crc32c_kernel()(~crc, data, size);
+}
+
+/*   store, load: little endian header fields
+ */
+static    void    cvector_io_store(uint8_t* ptr, uint64_t value, uint64_t size) {
+	uint64_t i;
+	for (i = 0; i < size; ++i, value >>= 8)
+		ptr[i] = (uint8_t) value;
+}
+
+static    uint64_t    cvector_io_load(const uint8_t* ptr, uint64_t size) {
+	uint64_t value = 0;
+	while (size-- > 0)
+		value = (value << 8) | ptr[size];
+	return value;
+}
+
+/*   header_make: fill a header
+ *   head: CVECTOR_IO_HEADER bytes
+ */
+static    void    cvector_io_header_make(uint8_t* head, uint64_t typesize, uint64_t count, uint16_t flags, uint32_t crc) {
+	memcpy(head, "CVEC", 4);
+	cvector_io_store(head + 4,  CVECTOR_IO_VERSION, 2);
+	cvector_io_store(head + 6,  flags, 2);
+	cvector_io_store(head + 8,  typesize, 8);
+	cvector_io_store(head + 16, count, 8);
+	cvector_io_store(head + 24, crc, 4);
+	cvector_io_store(head + 28, cvector_crc32c(0, head, 28), 4);
+}
+
+/*   read_full: read size bytes, retry short reads
+ *   return 0 if success, -1 if end of file or error
+ */
+static    int    cvector_io_read(int fd, void* ptr, uint64_t size) {
+	ssize_t n;
+	while (size > 0) {
+		n = read(fd, ptr, (size < CVECTOR_IO_CHUNK) ? size : CVECTOR_IO_CHUNK);
+		if ((n < 0) && (errno == EINTR))
+			continue;
+		if (n <= 0)
+			return -1;
+		ptr   = (uint8_t*) ptr + n;
+		size -= n;
+	}
+	return 0;
+}
+
+/*   left: bytes behind the current offset of a regular file
+ *   return byte count, UINT64_MAX if fd is a pipe or socket and the size is unknown
+ */
+static    uint64_t    cvector_io_left(int fd) {
+	struct stat st;
+	off_t offset;
+	if ((fstat(fd, &st) != 0) || !S_ISREG(st.st_mode))
+		return UINT64_MAX;
+	offset = lseek(fd, 0, SEEK_CUR);
+	if (offset < 0)
+		return UINT64_MAX;
+	return (st.st_size > offset) ? (uint64_t) (st.st_size - offset) : 0;
+}
+
+/*   write_full: write size bytes, retry short writes
+ *   return 0 if success, -1 if error
+ */
+static    int    cvector_io_write(int fd, const void* ptr, uint64_t size) {
+	ssize_t n;
+	while (size > 0) {
+		n = write(fd, ptr, (size < CVECTOR_IO_CHUNK) ? size : CVECTOR_IO_CHUNK);
+		if ((n < 0) && (errno == EINTR))
+			continue;
+		if (n <= 0)
+			return -1;
+		ptr   = (const uint8_t*) ptr + n;
+		size -= n;
+	}
+	return 0;
+}
+
+/*   cvector_save: write header and items to fd
+ *   thiz:  cvector pointer
+ *   fd:    file descriptor, written from its current offset
+ *   flags: CVECTOR_IO_CRC or 0
+ *   return: 0 if success, -1 if a write failed
+ */
+int      cvector_save(cvector *thiz, int fd, uint16_t flags) {
+	uint8_t head[CVECTOR_IO_HEADER];
+	uint64_t count, typesize;
+	uint32_t crc = 0;
+	void* data = NULL;
+	if ((thiz == NULL) || (fd < 0) || ((flags & ~CVECTOR_IO_CRC) != 0))
+		return -1;
+	// data moves pending items of an incremental vector first
+	data     = thiz->data(thiz);
+	count    = thiz->size(thiz);
+	typesize = thiz->typesize(thiz);
+	if (flags & CVECTOR_IO_CRC)
+		crc = cvector_crc32c(0, data, count * typesize);
+	cvector_io_header_make(head, typesize, count, flags, crc);
+	if (cvector_io_write(fd, head, sizeof(head)) != 0)
+		return -1;
+	return cvector_io_write(fd, data, count * typesize);
+}
+
+/*   cvector_load: read a saved cvector from fd, items stream into its buffer
+ *   fd:    file descriptor, read from its current offset, may be a pipe
+ *   return: cvector pointer, NULL if the header or crc is bad, the file is shorter than the header count,
+ *           short read or out of memory
+ */
+cvector* cvector_load(int fd) {
+	uint8_t head[CVECTOR_IO_HEADER];
+	uint64_t typesize, count, done, n, step, left, reserve;
+	uint32_t crc = 0;
+	uint16_t flags;
+	void* ptr = NULL;
+	cvector *thiz = NULL;
+	if ((fd < 0) || (cvector_io_read(fd, head, sizeof(head)) != 0))
+		return NULL;
+	if ((memcmp(head, "CVEC", 4) != 0) || (cvector_io_load(head + 4, 2) != CVECTOR_IO_VERSION))
+		return NULL;
+	if (cvector_io_load(head + 28, 4) != cvector_crc32c(0, head, 28))
+		return NULL;
+	flags    = cvector_io_load(head + 6, 2);
+	typesize = cvector_io_load(head + 8, 8);
+	count    = cvector_io_load(head + 16, 8);
+	if (((flags & ~CVECTOR_IO_CRC) != 0) || (typesize <= 0) || (count > UINT64_MAX / typesize))
+		return NULL;
+
+	// a regular file must hold every item, the header count is not trusted beyond that
+	left = cvector_io_left(fd);
+	if ((left != UINT64_MAX) && (count * typesize > left))
+		return NULL;
+
+	// a checked count is reserved once, a pipe reserves one chunk and grows as chunks arrive
+	step    = (CVECTOR_IO_CHUNK / typesize > 0) ? CVECTOR_IO_CHUNK / typesize : 1;
+	reserve = ((left != UINT64_MAX) || (count < step)) ? count : step;
+	thiz = cvector_alloc((reserve > 0) ? reserve : 1, typesize);
+	if (thiz == NULL)
+		return NULL;
+	for (done = 0; done < count; done += n) {
+		n   = (count - done < step) ? count - done : step;
+		ptr = thiz->append_uninitialized(thiz, n);
+		if ((ptr == NULL) || (cvector_io_read(fd, ptr, n * typesize) != 0)) {
+			thiz->free(thiz);
+			return NULL;
+		}
+		if (flags & CVECTOR_IO_CRC)
+			crc = cvector_crc32c(crc, ptr, n * typesize);
+	}
+	if ((flags & CVECTOR_IO_CRC) && (crc != cvector_io_load(head + 24, 4))) {
+		thiz->free(thiz);
+		return NULL;
+	}
+	return thiz;
+}
+
+
+/*   flush: rewrite the header with count and crc, needs a seekable fd
+ *   thiz: cvector_writer pointer
+ *   return 0 if success, -1 if a write failed
+ */
+static    int    cvector_writer_static_flush(cvector_writer *_thiz) {
+	uint8_t head[CVECTOR_IO_HEADER];
+	uint64_t done = 0;
+	ssize_t n;
+	cvector_writer_data *thiz = NULL;
+	if (_thiz == NULL)
+		return -1;
+	thiz = (cvector_writer_data*) _thiz;
+	if (thiz->failed || (thiz->offset < 0))
+		return -1;
+	cvector_io_header_make(head, thiz->typesize, thiz->count, thiz->flags, thiz->crc);
+	while (done < sizeof(head)) {
+		n = pwrite(thiz->fd, head + done, sizeof(head) - done, thiz->offset + done);
+		if ((n < 0) && (errno == EINTR))
+			continue;
+		if (n <= 0)
+			return -1;
+		done += n;
+	}
+	return 0;
+}
+
+/*   free: flush and free thiz, fd stays open
+ *   thiz: cvector_writer pointer
+ *   return 0 if flushed, -1 if a write failed
+ */
+static    int    cvector_writer_static_free(cvector_writer *_thiz) {
+	int ret;
+	if (_thiz == NULL)
+		return -1;
+	ret = cvector_writer_static_flush(_thiz);
+	free(_thiz);
+	return ret;
+}
+
+/*   count: get item count written
+ *   thiz: cvector_writer pointer
+ *   return item count
+ */
+static uint64_t    cvector_writer_static_count(cvector_writer *_thiz) {
+	if (_thiz == NULL)
+		return 0;
+	return ((cvector_writer_data*) _thiz)->count;
+}
+
+/*   append: write n items behind
+ *   thiz: cvector_writer pointer
+ *   src:  first item pointer
+ *   n:    item count
+ *   return 0 if success, -1 if a write failed
+ */
+static    int    cvector_writer_static_append(cvector_writer *_thiz, const void* src, uint64_t n) {
+	cvector_writer_data *thiz = NULL;
+	if (_thiz == NULL)
+		return -1;
+	thiz = (cvector_writer_data*) _thiz;
+	if (thiz->failed)
+		return -1;
+	if ((src == NULL) || (n <= 0))
+		return 0;
+	// a partial write leaves the file behind count, later appends would misplace items
+	if (cvector_io_write(thiz->fd, src, n * thiz->typesize) != 0) {
+		thiz->failed = 1;
+		return -1;
+	}
+	if (thiz->flags & CVECTOR_IO_CRC)
+		thiz->crc = cvector_crc32c(thiz->crc, src, n * thiz->typesize);
+	thiz->count = thiz->count + n;
+	return 0;
+}
+
+/*   sync: write the items of vec behind count, vec only grew since the last sync
+ *   thiz: cvector_writer pointer
+ *   vec:  cvector pointer, same typesize
+ *   return 0 if success, -1 if a write failed
+ */
+static    int    cvector_writer_static_sync(cvector_writer *_thiz, cvector *vec) {
+	uint64_t size;
+	cvector_writer_data *thiz = NULL;
+	if ((_thiz == NULL) || (vec == NULL))
+		return -1;
+	thiz = (cvector_writer_data*) _thiz;
+	size = vec->size(vec);
+	if ((vec->typesize(vec) != thiz->typesize) || (size < thiz->count))
+		return -1;
+	if (size == thiz->count)
+		return 0;
+	return cvector_writer_static_append(_thiz, (uint8_t*) vec->data(vec) + thiz->count * thiz->typesize, size - thiz->count);
+}
+
+/*   cvector_writer_alloc: write an empty header at the fd offset, items follow with append
+ *   fd:       file descriptor, seekable for flush
+ *   typesize: item size
+ *   flags:    CVECTOR_IO_CRC or 0
+ *   return: cvector_writer pointer, NULL if the header write failed
+ */
+cvector_writer* cvector_writer_alloc(int fd, uint64_t typesize, uint16_t flags) {
+	uint8_t head[CVECTOR_IO_HEADER];
+	cvector_writer *thiz = NULL;
+	cvector_writer_data *thiz_data = NULL;
+	if ((fd < 0) || (typesize <= 0) || ((flags & ~CVECTOR_IO_CRC) != 0))
+		return NULL;
+
+	thiz_data = (cvector_writer_data *)malloc(sizeof(cvector_writer_data));
+	if (thiz_data == NULL)
+		return NULL;
+	thiz_data->fd       = fd;
+	thiz_data->offset   = lseek(fd, 0, SEEK_CUR);
+	thiz_data->typesize = typesize;
+	thiz_data->count    = 0;
+	thiz_data->crc      = 0;
+	thiz_data->flags    = flags;
+	thiz_data->failed   = 0;
+	cvector_io_header_make(head, typesize, 0, flags, 0);
+	if (cvector_io_write(fd, head, sizeof(head)) != 0) {
+		free(thiz_data);
+		return NULL;
+	}
+
+	thiz = (cvector_writer*) &(thiz_data->writer);
+	thiz->free  = cvector_writer_static_free;
+	thiz->count  = cvector_writer_static_count;
+	thiz->append  = cvector_writer_static_append;
+	thiz->sync  = cvector_writer_static_sync;
+	thiz->flush  = cvector_writer_static_flush;
+	return thiz;
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#ifndef CVECTOR_IO_H_INCLUDED
+#define CVECTOR_IO_H_INCLUDED
+
+
+#include <stddef.h>
+#include <stdint.h>
+#include "cvector.h"
+
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+// file format, header fields little endian, items as they are in memory
+// 0      4        6      8          16       24        28         32
+// +------+--------+------+----------+--------+---------+----------+--------------------+
+// | CVEC | version| flags| typesize | count  | data crc| head crc | count * typesize   |
+// +------+--------+------+----------+--------+---------+----------+--------------------+
+// head crc is the crc32c of the first 28 bytes, data crc the crc32c of the items
+// or 0 without CVECTOR_IO_CRC
+#define CVECTOR_IO_VERSION  (1)
+#define CVECTOR_IO_HEADER   (32)
+
+// flags
+#define CVECTOR_IO_CRC      (1)
+
+struct cvector_writer_t;
+typedef struct cvector_writer_t cvector_writer;
+
+// append writer, the file grows with the vector during a run
+// flush rewrites the header in place, the file then loads with what was written
+struct cvector_writer_t {
+/*   free: flush and free thiz, fd stays open
+ *   thiz: cvector_writer pointer
+ *   return 0 if flushed, -1 if a write failed
+ */
+    int       (*free)(cvector_writer *thiz);
+
+/*   count: get item count written
+ *   thiz: cvector_writer pointer
+ *   return item count
+ */
+    uint64_t  (*count)(cvector_writer *thiz);
+
+/*   append: write n items behind
+ *   thiz: cvector_writer pointer
+ *   src:  first item pointer
+ *   n:    item count
+ *   return 0 if success, -1 if a write failed
+ */
+    int       (*append)(cvector_writer *thiz, const void* src, uint64_t n);
+
+/*   sync: write the items of vec behind count, vec only grew since the last sync
+ *   thiz: cvector_writer pointer
+ *   vec:  cvector pointer, same typesize
+ *   return 0 if success, -1 if a write failed
+ */
+    int       (*sync)(cvector_writer *thiz, cvector *vec);
+
+/*   flush: rewrite the header with count and crc, needs a seekable fd
+ *   thiz: cvector_writer pointer
+ *   return 0 if success, -1 if a write failed
+ */
+    int       (*flush)(cvector_writer *thiz);
+};
+
+/*   cvector_crc32c: crc32c (castagnoli) of size bytes
+ *   crc:  crc of the bytes before, 0 to start
+ *   data: bytes
+ *   size: byte count
+ *   return: crc
+ */
+uint32_t cvector_crc32c(uint32_t crc, const void* data, uint64_t size);
+
+/*   cvector_save: write header and items to fd
+ *   thiz:  cvector pointer
+ *   fd:    file descriptor, written from its current offset
+ *   flags: CVECTOR_IO_CRC or 0
+ *   return: 0 if success, -1 if a write failed
+ */
+int      cvector_save(cvector *thiz, int fd, uint16_t flags);
+
+/*   cvector_load: read a saved cvector from fd, items stream into its buffer
+ *   fd:    file descriptor, read from its current offset, may be a pipe
+ *   return: cvector pointer, NULL if the header or crc is bad, the file is shorter than the header count,
+ *           short read or out of memory
+ */
+cvector* cvector_load(int fd);
+
+/*   cvector_writer_alloc: write an empty header at the fd offset, items follow with append
+ *   fd:       file descriptor, seekable for flush
+ *   typesize: item size
+ *   flags:    CVECTOR_IO_CRC or 0
+ *   return: cvector_writer pointer, NULL if the header write failed
+ */
+cvector_writer* cvector_writer_alloc(int fd, uint64_t typesize, uint16_t flags);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -3,8 +3,10 @@
 #include  <stdint.h>
 #include  <stdlib.h>
 #include  <string.h>
+#include  <unistd.h>
 
 #include  "cvector.h"
+#include  "cvector_io.h"
 
 static void test_print(cvector *vec) {
     void *it = NULL;
@@ -42,9 +44,60 @@ static void test_vector1();
 
 static void test_vector2();
 
+static void test_vector3();
+
+static void test_vector4();
+
+static void test_vector5();
+
+static void test_vector6();
+
+static void test_vector7();
+
+static void test_vector8();
+
+static void test_vector9();
+
+static void test_vector10();
+
+static void test_vector11();
+
+static void test_vector12();
+
+static void test_vector13();
+
+static void test_vector14();
+
+static void test_vector15();
+
+static void test_vector16();
+
+static void test_vector17();
+
+static void test_vector18();
+
+static void test_vector19();
+
 int main(int argc, const char *argv[]) {
 	test_vector1();
 	test_vector2();
+	test_vector3();
+	test_vector4();
+	test_vector5();
+	test_vector6();
+	test_vector7();
+	test_vector8();
+	test_vector9();
+	test_vector10();
+	test_vector11();
+	test_vector12();
+	test_vector13();
+	test_vector14();
+	test_vector15();
+	test_vector16();
+	test_vector17();
+	test_vector18();
+	test_vector19();
 	return 0;
 }
 
@@ -118,4 +171,467 @@ void test_vector2() {
     printf("%d\n", vec2->equal(vec2, vec3));
     vec2->free(vec2);
     vec3->free(vec3);
+}
+
+void test_vector3() {
+    printf("test range\n");
+    int buf[] = {0x01, 0x12, 0x23, 0x34, 0x45};
+    cvector *vec = cvector_alloc(5, sizeof(int));
+    vec->assign(vec, buf, &buf[5]);
+    vec->insert(vec, vec->at(vec, 1), vec->begin(vec), vec->end(vec));
+    test_print(vec);
+    vec->fill(vec, vec->begin(vec), 3, vec->back(vec));
+    test_print(vec);
+    vec->erase(vec, vec->at(vec, 2), vec->at(vec, 10));
+    test_print(vec);
+    vec->free(vec);
+}
+
+void test_vector4() {
+    printf("test growth\n");
+    uint64_t growth[] = {CVECTOR_GROWTH_FACTOR, CVECTOR_GROWTH_STEP, CVECTOR_GROWTH_EXACT};
+    uint64_t step[]   = {150, 16, 0};
+    int i, j;
+    for (i = 0; i < 3; ++i) {
+        cvector *vec = cvector_alloc_growth(4, sizeof(int), growth[i], step[i]);
+        for (j = 0; j < 40; ++j) {
+            vec->push_back(vec, &j);
+        }
+        printf("%lld %lld %x %x\n", vec->size(vec), vec->capacity(vec),
+               *((int*) vec->front(vec)), *((int*) vec->back(vec)));
+        vec->free(vec);
+    }
+    printf("%d\n", cvector_alloc_growth(4, sizeof(int), CVECTOR_GROWTH_STEP, 0) == NULL);
+    printf("%d\n", cvector_alloc_growth(4, sizeof(int), CVECTOR_GROWTH_FACTOR, 100) == NULL);
+    // a factor this large overflows the new capacity, the push fails and keeps the items
+    cvector *vec = cvector_alloc_growth(4, sizeof(int), CVECTOR_GROWTH_FACTOR, UINT64_MAX);
+    for (j = 0; j < 5; ++j) {
+        vec->push_back(vec, &j);
+    }
+    printf("%lld %lld\n", vec->size(vec), vec->capacity(vec));
+    vec->free(vec);
+}
+
+void test_vector5() {
+    printf("test typesize\n");
+    char     str[] = "abcdefgh";
+    uint64_t ids[] = {0x1111, 0x2222, 0x3333};
+    cvector *vec1 = cvector_alloc(4, sizeof(char));
+    cvector *vec2 = cvector_alloc(2, sizeof(uint64_t));
+    uint64_t i;
+    for (i = 0; i < 8; ++i) {
+        vec1->push_back(vec1, &str[i]);
+    }
+    vec1->fill(vec1, vec1->at(vec1, 4), 2, &str[7]);
+    vec1->reverse(vec1);
+    for (i = 0; i < vec1->size(vec1); ++i) {
+        printf("%c", *((char*) vec1->at(vec1, i)));
+    }
+    printf(" %lld\n", vec1->size(vec1));
+
+    for (i = 0; i < 3; ++i) {
+        vec2->push_back(vec2, &ids[i]);
+    }
+    vec2->reverse(vec2);
+    vec2->copy(vec2, vec1);
+    vec1->push_back(vec1, &ids[0]);
+    for (i = 0; i < vec1->size(vec1); ++i) {
+        printf("%llx ", *((unsigned long long*) vec1->at(vec1, i)));
+    }
+    printf("%d %d\n", vec2->equal(vec2, vec1), vec1->at(vec1, 4) == NULL);
+    vec1->free(vec1);
+    vec2->free(vec2);
+}
+
+void test_vector6() {
+    printf("test fast\n");
+    int i, same = 1;
+    cvector *vec = cvector_alloc(4, sizeof(int));
+    for (i = 0; i < 10; ++i) {
+        cvector_fast_push_back(vec, &i);
+    }
+    for (i = 0; i < 12; ++i) {
+        same = same && (cvector_fast_at(vec, i) == vec->at(vec, i));
+    }
+    printf("%lld %d %d %d %d\n", cvector_fast_size(vec), same,
+           cvector_fast_data(vec) == vec->data(vec), cvector_fast_end(vec) == vec->end(vec),
+           *((int*) cvector_fast_at(vec, 9)));
+    printf("%lld %d\n", cvector_fast_size(NULL), cvector_fast_at(NULL, 0) == NULL);
+    vec->free(vec);
+}
+
+void test_vector7() {
+    printf("test append\n");
+    int buf[] = {0x01, 0x12, 0x23, 0x34, 0x45};
+    int i, *slot;
+    cvector *vec = cvector_alloc(2, sizeof(int));
+    slot = vec->emplace_back(vec);
+    *slot = 0x56;
+    vec->push_back_n(vec, buf, 5);
+    vec->push_back_n(vec, vec->begin(vec), 3);
+    slot = vec->append_uninitialized(vec, 3);
+    for (i = 0; i < 3; ++i) {
+        slot[i] = 0x60 + i;
+    }
+    test_print(vec);
+    vec->free(vec);
+}
+
+static uint8_t test_greater(const void *item, void *arg) {
+    return *((int*) item) > *((int*) arg);
+}
+
+void test_vector8() {
+    printf("test find\n");
+    int i, value;
+    cvector *vec = cvector_alloc(4, sizeof(int));
+    for (i = 0; i < 100; ++i) {
+        value = i % 7;
+        vec->push_back(vec, &value);
+    }
+    value = 3;
+    printf("%ld %ld %lld\n", (int*) vec->find(vec, &value) - (int*) vec->begin(vec),
+           (int*) vec->rfind(vec, &value) - (int*) vec->begin(vec), vec->count(vec, &value));
+    value = 7;
+    printf("%d %d %lld\n", vec->find(vec, &value) == NULL, vec->rfind(vec, &value) == NULL, vec->count(vec, &value));
+    value = 5;
+    printf("%ld\n", (int*) vec->find_if(vec, test_greater, &value) - (int*) vec->begin(vec));
+    vec->free(vec);
+}
+
+static int test_compare(const void *a, const void *b) {
+    return *((int*) a) - *((int*) b);
+}
+
+void test_vector9() {
+    printf("test sort\n");
+    int i, value;
+    cvector *vec = cvector_alloc(4, sizeof(int));
+    for (i = 0; i < 40; ++i) {
+        value = (i * 37) % 41;
+        vec->push_back(vec, &value);
+    }
+    vec->sort(vec, test_compare);
+    test_print(vec);
+    vec->reverse(vec);
+    printf("%d ", vec->radix_sort(vec, 0, 3));
+    printf("%d\n", vec->radix_sort(vec, 0, sizeof(int)));
+    test_print(vec);
+    vec->free(vec);
+}
+
+void test_vector10() {
+    printf("test parallel sort\n");
+    uint64_t i;
+    int value, sorted = 1;
+    cvector *vec = cvector_alloc(4, sizeof(int));
+    for (i = 0; i < 300000; ++i) {
+        value = (i * 4099) % 300007;
+        vec->push_back(vec, &value);
+    }
+    vec->parallel_sort(vec, test_compare, 3);
+    for (i = 1; i < vec->size(vec); ++i) {
+        sorted = sorted && (test_compare(vec->at(vec, i - 1), vec->at(vec, i)) <= 0);
+    }
+    printf("%lld %d %x %x\n", vec->size(vec), sorted, *((int*) vec->front(vec)), *((int*) vec->back(vec)));
+    vec->free(vec);
+}
+
+void test_vector11() {
+    printf("test bound\n");
+    int buf[] = {0x45, 0x12, 0x34, 0x12, 0x01, 0x23, 0x12};
+    int i, value;
+    void *first = NULL, *last = NULL;
+    cvector *vec = cvector_alloc(2, sizeof(int));
+    for (i = 0; i < 7; ++i) {
+        vec->sorted_insert(vec, &buf[i], test_compare);
+    }
+    test_print(vec);
+    value = 0x12;
+    vec->equal_range(vec, &value, test_compare, &first, &last);
+    printf("%ld %ld\n", (int*) first - (int*) vec->begin(vec), (int*) last - (int*) vec->begin(vec));
+    value = 0x50;
+    printf("%d ", vec->lower_bound(vec, &value, test_compare) == vec->end(vec));
+    value = 0x00;
+    printf("%d\n", vec->upper_bound(vec, &value, test_compare) == vec->begin(vec));
+    vec->free(vec);
+}
+
+void test_vector12() {
+    printf("test inline\n");
+    int buf[] = {0x01, 0x12, 0x23, 0x34, 0x45};
+    int i;
+    cvector *vec = cvector_alloc_inline(1, sizeof(int), 8);
+    vec->assign(vec, buf, &buf[5]);
+    test_print(vec);
+    for (i = 0; i < 5; ++i) {
+        vec->push_back(vec, &buf[i]);
+    }
+    test_print(vec);
+    vec->reserve(vec, 4);
+    test_print(vec);
+    vec->free(vec);
+}
+
+void test_vector13() {
+    printf("test slack\n");
+    int buf[] = {0x01, 0x12, 0x23, 0x34, 0x45};
+    int i;
+    cvector *vec = cvector_alloc_slack(4, sizeof(int));
+    for (i = 0; i < 5; ++i) {
+        vec->push_front(vec, &buf[i]);
+        vec->push_back(vec, &buf[i]);
+    }
+    test_print(vec);
+    vec->pop_front(vec);
+    vec->pop_front(vec);
+    vec->remove(vec, vec->at(vec, 1));
+    vec->insert(vec, vec->at(vec, 1), buf, &buf[2]);
+    test_print(vec);
+    for (i = 0; i < 100; ++i) {
+        vec->push_back(vec, &i);
+        vec->pop_front(vec);
+    }
+    printf("%llu %llu\n", (unsigned long long) vec->size(vec), (unsigned long long) vec->capacity(vec));
+    test_print(vec);
+    vec->clear(vec);
+    vec->push_front(vec, &buf[0]);
+    test_print(vec);
+    vec->free(vec);
+}
+
+void test_vector14() {
+    printf("test incremental\n");
+    int i, *item;
+    uint64_t j;
+    cvector *vec = cvector_alloc_incremental(4, sizeof(int), 1);
+    for (i = 0; i < 5; ++i) {
+        vec->push_back(vec, &i);
+    }
+    item = vec->at(vec, 3);
+    *item = 0x33;
+    for (j = 0; j < vec->size(vec); ++j) {
+        printf("%x ", *((int*) vec->at(vec, j)));
+    }
+    printf("\n");
+    for (i = 5; i < 9; ++i) {
+        cvector_fast_push_back(vec, &i);
+    }
+    vec->push_back(vec, cvector_fast_at(vec, 3));
+    test_print(vec);
+    vec->free(vec);
+}
+
+void test_vector15() {
+    printf("test snapshot\n");
+    int buf[] = {0x01, 0x12, 0x23, 0x34, 0x45};
+    uint64_t i;
+    cvector *vec = cvector_alloc(8, sizeof(int));
+    cvector *snap1, *snap2;
+    vec->push_back_n(vec, buf, 5);
+    snap1 = vec->snapshot(vec);
+    // the writer copies once, the snapshot keeps the old items
+    vec->pop_back(vec);
+    vec->push_back(vec, &buf[0]);
+    snap2 = vec->snapshot(vec);
+    vec->erase(vec, vec->begin(vec), vec->at(vec, 2));
+    // changes on a snapshot are ignored
+    snap1->push_back(snap1, &buf[0]);
+    snap1->clear(snap1);
+    test_print(vec);
+    test_print(snap1);
+    test_print(snap2);
+    snap1->free(snap1);
+    vec->free(vec);
+    for (i = 0; i < snap2->size(snap2); ++i) {
+        printf("%x ", *((int*) snap2->at(snap2, i)));
+    }
+    printf("\n");
+    snap2->free(snap2);
+    vec = cvector_alloc_inline(4, sizeof(int), 4);
+    vec->push_back_n(vec, buf, 3);
+    snap1 = vec->snapshot(vec);
+    vec->clear(vec);
+    test_print(snap1);
+    snap1->free(snap1);
+    vec->free(vec);
+    // writes through the item pointers of the writer stay in the writer
+    vec = cvector_alloc(8, sizeof(int));
+    vec->push_back_n(vec, buf, 4);
+    snap1 = vec->snapshot(vec);
+    *((int*) vec->at(vec, 1)) = 0x99;
+    snap2 = vec->snapshot(vec);
+    *((int*) vec->data(vec)) = 0x77;
+    *((int*) vec->back(vec)) = 0x88;
+    test_print(vec);
+    test_print(snap1);
+    test_print(snap2);
+    snap1->free(snap1);
+    snap2->free(snap2);
+    vec->free(vec);
+}
+
+void test_vector16() {
+    printf("test reverse, rotate\n");
+    uint8_t  bytes[100];
+    int i;
+    cvector *vec = cvector_alloc(8, sizeof(int));
+    cvector *big = cvector_alloc(8, sizeof(bytes));
+    for (i = 0; i < 20; ++i) {
+        vec->push_back(vec, &i);
+    }
+    vec->reverse(vec);
+    vec->rotate(vec, vec->at(vec, 5));
+    test_print(vec);
+    vec->rotate(vec, vec->end(vec));
+    vec->rotate(vec, vec->at(vec, 15));
+    vec->reverse(vec);
+    test_print(vec);
+    for (i = 0; i < 3; ++i) {
+        memset(bytes, i, sizeof(bytes));
+        big->push_back(big, bytes);
+    }
+    big->reverse(big);
+    printf("%d %d %d\n", *((uint8_t*) big->at(big, 0)), *((uint8_t*) big->at(big, 1) + 99), *((uint8_t*) big->back(big)));
+    vec->free(vec);
+    big->free(big);
+}
+
+void test_vector17() {
+    printf("test span\n");
+    int i, val = 7;
+    cvector_span span, odd, even;
+    cvector *vec = cvector_alloc(8, sizeof(int));
+    for (i = 0; i < 20; ++i) {
+        int item = 19 - i;
+        vec->push_back(vec, &item);
+    }
+    span = vec->span(vec, vec->at(vec, 4), vec->at(vec, 16));
+    printf("%llu %d %llu\n", (unsigned long long) span.count, *((int*) cvector_span_find(span, &val)), (unsigned long long) cvector_span_count(span, &val));
+    // sort the odd items of the slice in place, even ones stay
+    odd  = cvector_span_step(cvector_span_sub(span, 1, span.count), 2);
+    even = cvector_span_step(span, 2);
+    cvector_span_sort(odd, test_compare);
+    test_print(vec);
+    printf("%llu %d %d\n", (unsigned long long) odd.count, *((int*) cvector_span_at(odd, 0)), *((int*) cvector_span_at(even, 5)));
+    printf("%d %d\n", cvector_span_equal(span, vec->span(vec, vec->at(vec, 4), vec->at(vec, 16))),
+           cvector_span_equal(odd, even));
+    printf("%d %d\n", cvector_span_hash(even) == cvector_span_hash(cvector_span_step(cvector_span_sub(span, 0, 12), 2)),
+           cvector_span_hash(odd) == cvector_span_hash(even));
+    printf("%llu\n", (unsigned long long) vec->span(vec, vec->at(vec, 5), vec->at(vec, 2)).count);
+    vec->free(vec);
+}
+
+void test_vector18() {
+    printf("test save, load, writer\n");
+    char path[] = "/tmp/cvector_testXXXXXX";
+    int i, fd = mkstemp(path);
+    uint8_t byte;
+    cvector *vec = cvector_alloc(4, sizeof(int)), *load;
+    cvector_writer *writer;
+    unlink(path);
+    for (i = 0; i < 10; ++i)
+        vec->push_back(vec, &i);
+    printf("%x\n", cvector_crc32c(0, "123456789", 9));
+    // two vectors back to back, one with crc, one without
+    cvector_save(vec, fd, CVECTOR_IO_CRC);
+    vec->pop_back(vec);
+    cvector_save(vec, fd, 0);
+    lseek(fd, 0, SEEK_SET);
+    load = cvector_load(fd);
+    test_print(load);
+    load->free(load);
+    load = cvector_load(fd);
+    test_print(load);
+    load->free(load);
+    printf("%d\n", cvector_load(fd) == NULL);
+    // a flipped item byte fails the crc
+    pread(fd, &byte, 1, CVECTOR_IO_HEADER + 5);
+    byte ^= 0x40;
+    pwrite(fd, &byte, 1, CVECTOR_IO_HEADER + 5);
+    lseek(fd, 0, SEEK_SET);
+    printf("%d\n", cvector_load(fd) == NULL);
+    // a header count beyond the file size is refused before any reserve
+    uint8_t head[CVECTOR_IO_HEADER];
+    uint32_t crc;
+    pread(fd, head, sizeof(head), 0);
+    head[22] = 0x01;
+    crc = cvector_crc32c(0, head, 28);
+    for (i = 0; i < 4; ++i)
+        head[28 + i] = (uint8_t) (crc >> (8 * i));
+    pwrite(fd, head, sizeof(head), 0);
+    lseek(fd, 0, SEEK_SET);
+    printf("%d\n", cvector_load(fd) == NULL);
+    // a pipe has no size, load grows the vector as chunks arrive
+    int pipes[2];
+    pipe(pipes);
+    cvector_save(vec, pipes[1], CVECTOR_IO_CRC);
+    close(pipes[1]);
+    load = cvector_load(pipes[0]);
+    test_print(load);
+    load->free(load);
+    close(pipes[0]);
+
+    ftruncate(fd, 0);
+    lseek(fd, 0, SEEK_SET);
+    writer = cvector_writer_alloc(fd, sizeof(int), CVECTOR_IO_CRC);
+    vec->clear(vec);
+    for (i = 0; i < 5; ++i)
+        vec->push_back(vec, &i);
+    writer->sync(writer, vec);
+    writer->flush(writer);
+    lseek(fd, 0, SEEK_SET);
+    load = cvector_load(fd);
+    test_print(load);
+    load->free(load);
+    lseek(fd, 0, SEEK_END);
+    for (i = 5; i < 8; ++i)
+        vec->push_back(vec, &i);
+    writer->sync(writer, vec);
+    writer->append(writer, &i, 1);
+    printf("%llu %d\n", (unsigned long long) writer->count(writer), writer->sync(writer, vec));
+    writer->free(writer);
+    lseek(fd, 0, SEEK_SET);
+    load = cvector_load(fd);
+    test_print(load);
+    load->free(load);
+    close(fd);
+    vec->free(vec);
+}
+
+void test_vector19() {
+    printf("test swap, move_into, adopt, release\n");
+    int i, *items = malloc(8 * sizeof(int));
+    cvector *vec1 = cvector_alloc(4, sizeof(int)), *vec2 = cvector_alloc_inline(2, sizeof(int), 4), *vec3, *snap;
+    for (i = 0; i < 3; ++i)
+        items[i] = 0x10 + i;
+    vec3 = cvector_adopt(items, 3, 8, sizeof(int));
+    printf("%d %d\n", vec3->data(vec3) == items, cvector_adopt(NULL, 0, 1, sizeof(int)) == NULL);
+    for (i = 0; i < 6; ++i)
+        vec1->push_back(vec1, &i);
+    vec2->push_back(vec2, &i);
+    snap = vec1->snapshot(vec1);
+    vec1->swap(vec1, vec2);
+    test_print(vec1);
+    test_print(vec2);
+    vec2->push_back(vec2, &i);
+    test_print(snap);
+    vec3->move_into(vec3, vec2);
+    test_print(vec3);
+    test_print(vec2);
+    printf("%d %d\n", vec2->equal(vec2, vec1) == 0, vec2->equal(vec2, snap) == 0);
+    vec2->push_back(vec2, &i);
+    test_print(vec2);
+    snap->move_into(snap, vec3);
+    printf("%llu\n", (unsigned long long) vec3->size(vec3));
+    items = cvector_release(vec3);
+    for (i = 0; i < 7; ++i)
+        printf("%x ", items[i]);
+    printf("\n");
+    free(items);
+    items = cvector_release(vec2);
+    printf("%x\n", items[0]);
+    free(items);
+    snap->free(snap);
+    vec1->free(vec1);
 }
\ No newline at end of file